@@ -0,0 +1,503 @@
+// #################################################################################################
+//  ALib - A-Worx Utility Library
+//  Singleton Benchmark
+//
+//  Copyright 2019 A-Worx GmbH, Germany
+//  Published under Boost Software License (a free software license, see LICENSE.txt)
+//
+//  Measures the costs of singleton access and of registry operations. Results are written to the
+//  standard output as CSV (default) or JSON (option --json), one record per measurement.
+//  Option --max-threads N limits the contention measurements to N threads (default: number of
+//  hardware threads).
+// #################################################################################################
+
+#if !defined (HPP_ALIB_SINGLETONS_SINGLETON)
+#include "alib/singletons/singleton.hpp"
+#endif
+#if !defined (HPP_ALIB_SINGLETONS_REPLICATEDSINGLETON)
+#include "alib/singletons/replicatedsingleton.hpp"
+#endif
+#if !defined (HPP_ALIB_LIB_FLATTYPEMAP)
+#include "alib/lib/flattypemap.hpp"
+#endif
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// C++ run-time type information, needed to benchmark maps keyed by std::type_info
+#if defined(__GXX_RTTI) || defined(_CPPRTTI) || defined(__cpp_rtti)
+#   define BENCHMARK_RTTI 1
+#else
+#   define BENCHMARK_RTTI 0
+#endif
+
+namespace {
+
+// #################################################################################################
+// Measurement helpers
+// #################################################################################################
+
+using Clock= std::chrono::steady_clock;
+
+/** A result record. */
+struct Result
+{
+    const char*     benchmark;  ///< The name of the benchmark.
+    std::size_t     parameter;  ///< The number of threads or types.
+    std::size_t     operations; ///< The number of operations measured.
+    double          nsPerOp;    ///< The nanoseconds per operation.
+};
+
+std::vector<Result> results;
+
+/** Prevents the compiler from optimizing away the computation of \p{value}. */
+template<typename T>
+inline void doNotOptimize( T* value )
+{
+    #if defined(__GNUC__) || defined(__clang__)
+        asm volatile( "" : : "g"(value) : "memory" );
+    #else
+        static T* volatile sink;
+        sink= value;
+    #endif
+}
+
+/** Returns the nanoseconds passed since \p{start}. */
+inline double nanosSince( Clock::time_point start )
+{
+    return std::chrono::duration<double, std::nano>( Clock::now() - start ).count();
+}
+
+/** Adds a result record. */
+void record( const char* benchmark, std::size_t parameter, std::size_t operations, double nanos )
+{
+    results.push_back( Result{ benchmark, parameter, operations, nanos / static_cast<double>( operations ) } );
+}
+
+const char* mode()
+{
+    #if ALIB_FEAT_SINGLETON_THREAD_CACHE
+        return "mapped-threadcache";
+    #elif ALIB_FEAT_SINGLETON_STATISTICS
+        return "mapped-statistics";
+    #elif ALIB_FEAT_SINGLETON_MAPPED && !BENCHMARK_RTTI
+        return "mapped-nortti";
+    #elif ALIB_FEAT_SINGLETON_MAPPED
+        return "mapped";
+    #else
+        return "unmapped";
+    #endif
+}
+
+// #################################################################################################
+// Hot path access
+// #################################################################################################
+
+struct Hot : public aworx::Singleton<Hot> { int value= 0; };
+
+struct HotStatic : public aworx::PlainSingleton<HotStatic> { int value; constexpr HotStatic() : value( 0 ) {} };
+
+struct HotReplicated : public aworx::ReplicatedSingleton<HotReplicated> { int value= 0; };
+
+} // anonymous namespace
+
+ALIB_SINGLETON_STATIC_STORAGE( HotStatic )
+
+namespace {
+
+struct Plain { int value= 0; };
+
+Plain& functionLocalStatic()
+{
+    static Plain instance;
+    return instance;
+}
+
+std::once_flag  onceFlag;
+Plain*          oncePointer;
+Plain& callOnce()
+{
+    std::call_once( onceFlag, []() { oncePointer= new Plain(); } );
+    return *oncePointer;
+}
+
+Plain           globalInstance;
+
+template<typename TAccess>
+void measureAccess( const char* benchmark, std::size_t iterations, TAccess access )
+{
+    doNotOptimize( &access() );
+    Clock::time_point start= Clock::now();
+    for( std::size_t i= 0 ; i < iterations ; ++i )
+        doNotOptimize( &access() );
+    record( benchmark, 1, iterations, nanosSince( start ) );
+}
+
+void hotPath( std::size_t iterations )
+{
+    measureAccess( "hot/GetSingleton"        , iterations, []() -> Hot&   { return Hot::GetSingleton(); } );
+    measureAccess( "hot/static-storage"      , iterations, []() -> HotStatic& { return HotStatic::GetSingleton(); } );
+    measureAccess( "hot/ReplicatedSingleton" , iterations, []() -> HotReplicated& { return HotReplicated::GetReplica(); } );
+    aworx::SingletonHandle<Hot> handle;
+    measureAccess( "hot/SingletonHandle"     , iterations, [&handle]() -> Hot& { return handle.Get(); } );
+    measureAccess( "hot/SingletonReadGuard"  , iterations, []() -> Hot&   { aworx::SingletonReadGuard guard;
+                                                                            return Hot::GetSingleton(); } );
+    measureAccess( "hot/function-local-static", iterations, []() -> Plain& { return functionLocalStatic(); } );
+    measureAccess( "hot/call_once"           , iterations, []() -> Plain& { return callOnce(); } );
+    measureAccess( "hot/global"              , iterations, []() -> Plain& { return globalInstance; } );
+}
+
+// #################################################################################################
+// Cold (first) access
+// #################################################################################################
+
+template<int N> struct Cold : public aworx::Singleton<Cold<N>> { int value= N; };
+
+template<int N> struct ColdAccess
+{
+    static void Run( double& nanos )
+    {
+        ColdAccess<N - 1>::Run( nanos );
+        Clock::time_point start= Clock::now();
+        doNotOptimize( &Cold<N>::GetSingleton() );
+        nanos+= nanosSince( start );
+    }
+};
+
+template<> struct ColdAccess<-1>
+{
+    static void Run( double& ) {}
+};
+
+void coldAccess()
+{
+    constexpr int Types= 64;
+    double nanos= 0;
+    ColdAccess<Types - 1>::Run( nanos );
+    record( "cold/GetSingleton", Types, Types, nanos );
+}
+
+// #################################################################################################
+// Contention
+// #################################################################################################
+
+void contention( std::size_t iterations, unsigned int maxThreads )
+{
+    for( unsigned int threadCount= 1 ;; threadCount= threadCount * 2 < maxThreads ? threadCount * 2
+                                                                                 : maxThreads )
+    {
+        std::vector<std::thread> threads;
+        Clock::time_point start= Clock::now();
+        for( unsigned int t= 0 ; t < threadCount ; ++t )
+            threads.emplace_back( [iterations]()
+            {
+                for( std::size_t i= 0 ; i < iterations ; ++i )
+                    doNotOptimize( &Hot::GetSingleton() );
+            } );
+        for( auto& thread : threads )
+            thread.join();
+
+        // wall time per operation of one thread: constant if threads scale perfectly
+        record( "contention/GetSingleton", threadCount, iterations, nanosSince( start ) );
+
+        if( threadCount == maxThreads )
+            break;
+    }
+}
+
+// #################################################################################################
+// Generated type keys (mapped mode only)
+// #################################################################################################
+#if ALIB_FEAT_SINGLETON_MAPPED
+
+/** Creates \p{count} keys of generated types. The names are stored in \p{names}. */
+std::vector<aworx::lib::TypeKey> generateKeys( std::size_t count, std::vector<std::string>& names )
+{
+    names.clear();
+    names.reserve( count );
+    std::vector<aworx::lib::TypeKey> keys;
+    keys.reserve( count );
+    for( std::size_t i= 0 ; i < count ; ++i )
+    {
+        names.push_back( "Generated<" + std::to_string( i ) + ">" );
+        const std::string& name= names.back();
+        keys.emplace_back( name.data(), name.size(), nullptr,
+                           aworx::lib::detail::hashCodeOf( { name.data(), name.size() } ) );
+    }
+    return keys;
+}
+#endif
+
+// #################################################################################################
+// Type maps (measured once, with the mapped mode executable)
+// #################################################################################################
+#if ALIB_FEAT_SINGLETON_MAPPED && !ALIB_FEAT_SINGLETON_THREAD_CACHE && !ALIB_FEAT_SINGLETON_STATISTICS \
+    && BENCHMARK_RTTI
+
+template<int A, int B> struct Keyed {};
+
+template<int... N> struct Indices {};
+template<int TCount, int... N> struct MakeIndices : MakeIndices<TCount - 1, TCount - 1, N...> {};
+template<int... N> struct MakeIndices<0, N...> { using type= Indices<N...>; };
+
+/** Collects the type information of types <c>Keyed<A, B></c> for all \c B. */
+template<int A, typename TIndices> struct CollectRow;
+template<int A, int... B> struct CollectRow<A, Indices<B...>>
+{
+    static void Run( std::vector<std::reference_wrapper<const std::type_info>>& infos )
+    {
+        const std::type_info* row[]= { &typeid( Keyed<A, B> )... };
+        for( const std::type_info* info : row )
+            infos.push_back( *info );
+    }
+};
+
+/** Collects the type information of 100 x 100 generated types. */
+template<typename TIndices> struct CollectRows;
+template<int... A> struct CollectRows<Indices<A...>>
+{
+    static void Run( std::vector<std::reference_wrapper<const std::type_info>>& infos )
+    {
+        int expand[]= { ( CollectRow<A, MakeIndices<100>::type>::Run( infos ), 0 )... };
+        (void) expand;
+    }
+};
+
+/** Measures \p{lookups} invocations of <c>count()</c> with keys in pseudo-random order. */
+template<typename TMap, typename TKey>
+void measureLookup( const char* benchmark, const TMap& map, const std::vector<TKey>& keys,
+                    std::size_t lookups )
+{
+    std::vector<std::size_t> order( 4096 );
+    std::uint64_t state= 1;
+    for( std::size_t& idx : order )
+    {
+        state= state * 6364136223846793005ull + 1442695040888963407ull;
+        idx  = static_cast<std::size_t>( state >> 33 ) % keys.size();
+    }
+
+    std::size_t found= 0;
+    Clock::time_point start= Clock::now();
+    for( std::size_t i= 0 ; i < lookups ; ++i )
+        found+= map.count( keys[order[i & 4095]] );
+    record( benchmark, keys.size(), lookups, nanosSince( start ) );
+    doNotOptimize( &found );
+}
+
+/** Inserts \p{keys} into \p{map}, then measures lookups. */
+template<typename TMap, typename TKey>
+void mapLookup( const char* benchmark, const std::vector<TKey>& keys, std::size_t lookups )
+{
+    TMap map;
+    for( const TKey& key : keys )
+        map[key]= 1;
+    measureLookup( benchmark, map, keys, lookups );
+}
+
+/** Inserts \p{keys} into \p{set}, then measures lookups. */
+template<typename TSet, typename TKey>
+void setLookup( const char* benchmark, const std::vector<TKey>& keys, std::size_t lookups )
+{
+    TSet set;
+    for( const TKey& key : keys )
+        set.insert( key );
+    measureLookup( benchmark, set, keys, lookups );
+}
+
+/** Compares the standard type maps and sets with their flat (open-addressing) counterparts. */
+void typeMaps( std::size_t lookups )
+{
+    using aworx::lib::TypeKey;
+    using TypeInfo= std::reference_wrapper<const std::type_info>;
+    std::vector<TypeInfo> allInfos;
+    CollectRows<MakeIndices<100>::type>::Run( allInfos );
+
+    std::vector<std::string> names;
+    for( std::size_t count : { std::size_t(10), std::size_t(100), std::size_t(10000) } )
+    {
+        std::vector<TypeInfo> infos( allInfos.begin(), allInfos.begin() + static_cast<std::ptrdiff_t>( count ) );
+        mapLookup<aworx::TypeMap    <int>>( "typemap/TypeMap"    , infos, lookups );
+        mapLookup<aworx::FlatTypeMap<int>>( "typemap/FlatTypeMap", infos, lookups );
+        setLookup<aworx::TypeSet         >( "typeset/TypeSet"    , infos, lookups );
+        setLookup<aworx::FlatTypeSet<>   >( "typeset/FlatTypeSet", infos, lookups );
+
+        std::vector<TypeKey> keys= generateKeys( count, names );
+        mapLookup<aworx::TypeKeyMap <int         >>( "typemap/TypeKeyMap"         , keys, lookups );
+        mapLookup<aworx::FlatTypeMap<int, TypeKey>>( "typemap/FlatTypeMap-TypeKey", keys, lookups );
+        setLookup<aworx::FlatTypeSet<     TypeKey>>( "typeset/FlatTypeSet-TypeKey", keys, lookups );
+    }
+}
+#endif
+
+// #################################################################################################
+// Registry operations (mapped mode only)
+// #################################################################################################
+#if ALIB_FEAT_SINGLETON_MAPPED
+
+using aworx::lib::TypeKey;
+
+struct Dummy { std::size_t value; };
+
+void deleteDummy( void* dummy )
+{
+    delete static_cast<Dummy*>( dummy );
+}
+
+void insertAll( const std::vector<TypeKey>& keys )
+{
+    using namespace aworx::lib::singletons;
+    for( std::size_t i= 0 ; i < keys.size() ; ++i )
+    {
+        Dummy* found;
+        if( !getSingleton( keys[i], &found ) )
+            storeSingleton( keys[i], new Dummy{ i }, &deleteDummy );
+    }
+}
+
+void registry( std::size_t lookups )
+{
+    using namespace aworx::lib::singletons;
+    std::vector<std::string> names;
+    for( std::size_t count : { std::size_t(10), std::size_t(1000), std::size_t(100000) } )
+    {
+        std::vector<TypeKey> keys= generateKeys( count, names );
+
+        Clock::time_point start= Clock::now();
+        insertAll( keys );
+        record( "registry/insert", count, count, nanosSince( start ) );
+
+        std::size_t rounds= lookups / count + 1;
+        start= Clock::now();
+        for( std::size_t round= 0 ; round < rounds ; ++round )
+            for( const TypeKey& key : keys )
+            {
+                Dummy* found;
+                getSingleton( key, &found );
+                doNotOptimize( found );
+            }
+        record( "registry/lookup", count, rounds * count, nanosSince( start ) );
+
+        std::vector<Dummy*> dummies( count );
+        for( std::size_t i= 0 ; i < count ; ++i )
+            getSingleton( keys[i], &dummies[i] );
+        start= Clock::now();
+        for( std::size_t i= 0 ; i < count ; ++i )
+            removeSingleton( keys[i], dummies[i] );
+        record( "registry/remove", count, count, nanosSince( start ) );
+        for( Dummy* dummy : dummies )
+            delete dummy;
+        DeleteSingletons();
+
+        insertAll( keys );
+        start= Clock::now();
+        DeleteSingletons( 1 );
+        record( "registry/DeleteSingletons", count, count, nanosSince( start ) );
+
+        unsigned int threadCount= std::thread::hardware_concurrency();
+        if( threadCount > 1 )
+        {
+            insertAll( keys );
+            start= Clock::now();
+            DeleteSingletons( threadCount );
+            record( "registry/DeleteSingletons-parallel", count, count, nanosSince( start ) );
+        }
+    }
+}
+
+void lookupContention( std::size_t lookups, unsigned int maxThreads )
+{
+    using namespace aworx::lib::singletons;
+    std::vector<std::string> names;
+    std::vector<TypeKey>     keys= generateKeys( 1000, names );
+    insertAll( keys );
+
+    for( unsigned int threadCount= 1 ;; threadCount= threadCount * 2 < maxThreads ? threadCount * 2
+                                                                                 : maxThreads )
+    {
+        std::vector<std::thread> threads;
+        Clock::time_point start= Clock::now();
+        for( unsigned int t= 0 ; t < threadCount ; ++t )
+            threads.emplace_back( [lookups, t, &keys]()
+            {
+                // threads start at different keys
+                for( std::size_t i= 0 ; i < lookups ; ++i )
+                {
+                    Dummy* found;
+                    getSingleton( keys[( i + t * 61 ) % keys.size()], &found );
+                    doNotOptimize( found );
+                }
+            } );
+        for( auto& thread : threads )
+            thread.join();
+
+        // wall time per lookup of one thread: constant if threads scale perfectly
+        record( "registry/lookup-contention", threadCount, lookups, nanosSince( start ) );
+
+        if( threadCount == maxThreads )
+            break;
+    }
+    DeleteSingletons();
+}
+#endif
+
+} // anonymous namespace
+
+int main( int argc, char** argv )
+{
+    bool         json      = false;
+    unsigned int maxThreads= std::thread::hardware_concurrency();
+    for( int i= 1 ; i < argc ; ++i )
+    {
+        if( std::strcmp( argv[i], "--json" ) == 0 )
+            json= true;
+        else if( std::strcmp( argv[i], "--max-threads" ) == 0 && i + 1 < argc )
+            maxThreads= static_cast<unsigned int>( std::atoi( argv[++i] ) );
+        else
+        {
+            std::fprintf( stderr, "Usage: %s [--json] [--max-threads N]\n", argv[0] );
+            return 1;
+        }
+    }
+    if( maxThreads == 0 )
+        maxThreads= 1;
+
+    hotPath    ( 100000000 );
+    coldAccess ();
+    contention ( 10000000, maxThreads );
+    #if ALIB_FEAT_SINGLETON_MAPPED && !ALIB_FEAT_SINGLETON_THREAD_CACHE && !ALIB_FEAT_SINGLETON_STATISTICS \
+        && BENCHMARK_RTTI
+        typeMaps( 2000000 );
+    #endif
+
+    // delete all singletons: must be the last benchmarks
+    #if ALIB_FEAT_SINGLETON_MAPPED
+        lookupContention( 2000000, maxThreads );
+        registry        ( 10000000 );
+    #endif
+
+    if( json )
+    {
+        std::printf( "[\n" );
+        for( std::size_t i= 0 ; i < results.size() ; ++i )
+            std::printf( "  { \"benchmark\": \"%s\", \"mode\": \"%s\", \"parameter\": %zu, "
+                         "\"operations\": %zu, \"ns_per_op\": %.3f }%s\n",
+                         results[i].benchmark, mode(), results[i].parameter, results[i].operations,
+                         results[i].nsPerOp, i + 1 < results.size() ? "," : "" );
+        std::printf( "]\n" );
+    }
+    else
+    {
+        std::printf( "benchmark,mode,parameter,operations,ns_per_op\n" );
+        for( const Result& result : results )
+            std::printf( "%s,%s,%zu,%zu,%.3f\n", result.benchmark, mode(), result.parameter,
+                         result.operations, result.nsPerOp );
+    }
+    return 0;
+}
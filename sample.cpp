@@ -10,10 +10,6 @@
 #include "alib/singletons/singleton.hpp"
 #endif
 
-#if !defined (HPP_ALIB_LIB_TYPEDEMANGLER)
-#   include "alib/lib/typedemangler.hpp"
-#endif
-
 #include <iostream>
 
 
@@ -33,25 +29,21 @@ class JustOne : public aworx::Singleton<JustOne>
 };
 
 
-#if ALIB_DEBUG && ALIB_FEAT_SINGLETON_MAPPED
-
-// import the map of singletons. This is not done in the header files by purpose!
-namespace aworx { namespace lib { namespace singletons {
-    extern ALIB_API TypeMap<void*>  singletonMap;
-}}}
-
+#if ALIB_FEAT_SINGLETON_MAPPED
 
-// A simple debug dump function
+// A simple dump function
 void  DumpSingletons()
 {
-    std::cout << "Debug-Mode: Dumping Singletons: " << std::endl;
+    std::cout << "Dumping Singletons: " << std::endl;
 
-    for( auto it : aworx::lib::singletons::singletonMap )
-        std::cout << "  "
-             << aworx::lib::DbgTypeDemangler(it.first.get()).Get()
+    aworx::lib::singletons::VisitSingletons( []( const aworx::lib::TypeKey& type, void* singleton )
+    {
+        std::cout << "  ";
+        std::cout.write( type.Name(), static_cast<std::streamsize>( type.NameLength() ) )
              << " = 0x" << std::hex
-             << reinterpret_cast<uint64_t>(it.second)
+             << reinterpret_cast<uint64_t>(singleton)
              << std::endl;
+    } );
 }
 #endif
 
@@ -73,7 +65,7 @@ int main()
     // The dump function is only available if symbol ALIB_FEAT_SINGLETON_MAPPED is true.
     // On GNU/Linux and mac this defaults to false. (On Windows OS to true.)
     // The sample's cmake file however overwrites the default value for demonstration purpose!
-    #if ALIB_DEBUG && ALIB_FEAT_SINGLETON_MAPPED
+    #if ALIB_FEAT_SINGLETON_MAPPED
         DumpSingletons();
     #endif
 
@@ -0,0 +1,24 @@
+// #################################################################################################
+//  ALib - A-Worx Utility Library
+//  Singleton Plugin Sample
+//
+//  Copyright 2019 A-Worx GmbH, Germany
+//  Published under Boost Software License (a free software license, see LICENSE.txt)
+//
+//  A plugin, loaded by sample_plugins.cpp. Compiled once per plugin name.
+// #################################################################################################
+#include "sample_plugin.hpp"
+
+const char* ModuleName()
+{
+    return "plugin " SAMPLE_PLUGIN_NAME;
+}
+
+extern "C" __attribute__((visibility("default")))
+void PluginRun( PluginResult* result )
+{
+    Counter& counter= Counter::GetSingleton();
+    counter.Value++;
+    result->counter = &counter;
+    result->greeting= Greeting::GetSingleton().Creator;
+}
@@ -0,0 +1,53 @@
+// #################################################################################################
+//  ALib - A-Worx Utility Library
+//  Singleton Plugin Sample
+//
+//  Copyright 2019 A-Worx GmbH, Germany
+//  Published under Boost Software License (a free software license, see LICENSE.txt)
+//
+//  Types shared by the executable (sample_plugins.cpp) and the plugins (sample_plugin.cpp).
+// #################################################################################################
+#ifndef HPP_ALIB_SAMPLE_PLUGIN
+#define HPP_ALIB_SAMPLE_PLUGIN 1
+
+#if !defined (HPP_ALIB_SINGLETONS_SINGLETON)
+#include "alib/singletons/singleton.hpp"
+#endif
+
+#include <atomic>
+
+// The name of the code entity. Defined by the executable and by each plugin.
+const char* ModuleName();
+
+// Created by the executable and incremented by everybody.
+class Counter : public aworx::Singleton<Counter>
+{
+    public:
+        std::atomic<int>    Value;
+
+        Counter() : Value( 0 ) {}
+};
+
+// Created by the code entity that requests it first. Its virtual function is located in that
+// code entity, hence the singleton has to be deleted before that entity is unloaded.
+class Greeting : public aworx::Singleton<Greeting>
+{
+    public:
+        const char*         Creator;
+
+        Greeting() : Creator( ModuleName() ) {}
+
+        virtual const char* Text() const { return "Hello"; }
+};
+
+// The result of function PluginRun of a plugin.
+struct PluginResult
+{
+    Counter*            counter;    // The counter as received by the plugin.
+    const char*         greeting;   // The creator of the greeting as received by the plugin.
+};
+
+// The function exported by the plugins.
+using PluginRunFunction= void (*)( PluginResult* );
+
+#endif // HPP_ALIB_SAMPLE_PLUGIN
@@ -0,0 +1,111 @@
+// #################################################################################################
+//  ALib - A-Worx Utility Library
+//  Singleton Plugin Sample
+//
+//  Copyright 2019 A-Worx GmbH, Germany
+//  Published under Boost Software License (a free software license, see LICENSE.txt)
+//
+//  Loads two plugins with dlopen(RTLD_LOCAL). The executable, the plugins and the ALib library
+//  are compiled with hidden visibility, hence each has its own copy of the static members of
+//  class Singleton. The singleton registry of mapped mode makes them share the singletons.
+//  Before a plugin is unloaded, the singletons it constructed are deleted with
+//  DeleteModuleSingletons(). Returns 1 if a singleton is not shared as expected.
+// #################################################################################################
+#include "sample_plugin.hpp"
+
+#include <cstring>
+#include <dlfcn.h>
+#include <iostream>
+
+const char* ModuleName()
+{
+    return "executable";
+}
+
+namespace {
+
+int failures= 0;
+
+void check( bool condition, const char* description )
+{
+    std::cout << ( condition ? "  ok:     " : "  FAILED: " ) << description << std::endl;
+    if( !condition )
+        ++failures;
+}
+
+struct Plugin
+{
+    const char*         path;
+    void*               handle;
+    PluginRunFunction   run;
+};
+
+bool load( Plugin& plugin )
+{
+    plugin.handle= dlopen( plugin.path, RTLD_NOW | RTLD_LOCAL );
+    if( plugin.handle == nullptr )
+    {
+        std::cout << "  FAILED: " << dlerror() << std::endl;
+        ++failures;
+        return false;
+    }
+    plugin.run= reinterpret_cast<PluginRunFunction>( dlsym( plugin.handle, "PluginRun" ) );
+    return true;
+}
+
+void unload( Plugin& plugin )
+{
+    std::size_t deleted= aworx::lib::singletons::DeleteModuleSingletons(
+                                              reinterpret_cast<const void*>( plugin.run ) );
+    std::cout << "Unloading " << plugin.path << ": " << deleted << " singleton(s) deleted" << std::endl;
+    dlclose( plugin.handle );
+
+    // libraries that define unique symbols are never unloaded
+    void* handle= dlopen( plugin.path, RTLD_NOW | RTLD_NOLOAD );
+    check( handle == nullptr, "plugin unloaded" );
+    if( handle != nullptr )
+        dlclose( handle );
+}
+
+} // anonymous namespace
+
+int main()
+{
+    Counter::GetSingleton().Value++;
+
+    Plugin plugins[2]= { { SAMPLE_PLUGIN_A, nullptr, nullptr },
+                         { SAMPLE_PLUGIN_B, nullptr, nullptr } };
+    for( Plugin& plugin : plugins )
+        if( !load( plugin ) )
+            return 1;
+
+    std::cout << "Plugins loaded" << std::endl;
+    PluginResult result;
+    plugins[0].run( &result );
+    check( result.counter == &Counter::GetSingleton()        , "plugin A shares the counter" );
+    check( std::strcmp( result.greeting, "plugin A" ) == 0   , "plugin A created the greeting" );
+    plugins[1].run( &result );
+    check( result.counter == &Counter::GetSingleton()        , "plugin B shares the counter" );
+    check( std::strcmp( result.greeting, "plugin A" ) == 0   , "plugin B shares the greeting" );
+    check( std::strcmp( Greeting::GetSingleton().Creator, "plugin A" ) == 0,
+           "executable shares the greeting" );
+
+    // the greeting's code is located in plugin A: it is deleted and created again when requested
+    unload( plugins[0] );
+    check( std::strcmp( Greeting::GetSingleton().Creator, "executable" ) == 0,
+           "executable created a new greeting" );
+    check( std::strcmp( Greeting::GetSingleton().Text(), "Hello" ) == 0, "greeting is usable" );
+    plugins[1].run( &result );
+    check( result.counter == &Counter::GetSingleton()        , "plugin B shares the counter" );
+    check( std::strcmp( result.greeting, "executable" ) == 0 , "plugin B shares the new greeting" );
+
+    // the counter is kept, while the registry forgets the pointers of plugin B
+    unload( plugins[1] );
+    check( Counter::GetSingleton().Value == 4                , "counter survived unloading" );
+
+    aworx::lib::singletons::DeleteSingletons();
+    check( Counter::GetSingleton().Value == 0                , "counter created again" );
+    aworx::lib::singletons::DeleteSingletons();
+
+    return failures == 0 ? 0 : 1;
+}
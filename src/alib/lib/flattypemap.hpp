@@ -0,0 +1,764 @@
+// #################################################################################################
+//  ALib C++ Library
+//
+//  Copyright 2013-2019 A-Worx GmbH, Germany
+//  Published under 'Boost Software License' (a free software license, see LICENSE.txt)
+// #################################################################################################
+#ifndef HPP_ALIB_LIB_FLATTYPEMAP
+#define HPP_ALIB_LIB_FLATTYPEMAP 1
+
+
+#if !defined(HPP_ALIB_LIB_TYPEMAP)
+#   include "alib/lib/typemap.hpp"
+#endif
+
+#if !defined (_GLIBCXX_CSTDINT) && !defined(_CSTDINT_)
+    #include <cstdint>
+#endif
+
+#if !defined (_GLIBCXX_CSTRING) && !defined(_CSTRING_)
+    #include <cstring>
+#endif
+
+#if !defined (_GLIBCXX_NEW) && !defined(_NEW_)
+    #include <new>
+#endif
+
+#if !defined (_GLIBCXX_UTILITY) && !defined(_UTILITY_)
+    #include <utility>
+#endif
+
+#if !defined (_GLIBCXX_ITERATOR) && !defined(_ITERATOR_)
+    #include <iterator>
+#endif
+
+#if !defined (_GLIBCXX_TYPE_TRAITS) && !defined(_TYPE_TRAITS_)
+    #include <type_traits>
+#endif
+
+
+namespace aworx { namespace lib {
+
+//! @cond NO_DOX
+namespace detail {
+
+/**
+ * Open-addressing hash table used by \alib{FlatTypeMap} and \alib{FlatTypeSet}.
+ *
+ * The table stores one control byte per slot in a contiguous array, separated from the
+ * (equally contiguous) slots. A control byte denotes an empty or a deleted slot, or holds
+ * seven bits of the hash code of the slot's key. Slots are probed in groups of eight, by
+ * matching the eight control bytes of a group at once using 64-bit integer arithmetic.
+ * Hence, keys are compared only in the (rare) case that these seven bits match.
+ *
+ * Deleted slots are marked only in groups that were full, because only those may be passed
+ * by the probe sequence of other keys.
+ *
+ * @tparam TKey    The key type.
+ * @tparam TValue  The type stored in the slots.
+ * @tparam TKeyOf  Functor that returns the key of a value.
+ */
+template<typename TKey, typename TValue, typename TKeyOf>
+class FlatTypeTable
+{
+    protected:
+        /** Control byte of empty slots. */
+        static constexpr std::uint8_t   Empty    = 0x80;
+
+        /** Control byte of deleted slots. */
+        static constexpr std::uint8_t   Deleted  = 0xFE;
+
+        /** The number of slots in a group. */
+        static constexpr std::size_t    GroupSize= 8;
+
+        /** Raw storage of a value. */
+        using Slot= typename std::aligned_storage<sizeof(TValue), alignof(TValue)>::type;
+
+        std::uint8_t*   ctrl;       ///< The control bytes.
+        Slot*           slots;      ///< The slots.
+        std::size_t     capacity;   ///< The number of slots. A power of 2 and at least #GroupSize.
+        std::size_t     used;       ///< The number of values.
+        std::size_t     growthLeft; ///< The number of insertions left before growing.
+
+    public:
+        /** Iterator template, used for iterator and const iterator. */
+        template<typename TConstOrMutable>
+        class TIterator
+        {
+            public:
+                using iterator_category= std::forward_iterator_tag;  ///< Iterator category.
+                using value_type       = TConstOrMutable;            ///< Value type.
+                using difference_type  = std::ptrdiff_t;             ///< Difference type.
+                using pointer          = TConstOrMutable*;           ///< Pointer type.
+                using reference        = TConstOrMutable&;           ///< Reference type.
+
+            protected:
+                friend class FlatTypeTable;
+                const FlatTypeTable*  table;  ///< The table.
+                std::size_t           idx;    ///< The slot index.
+
+                /** Moves #idx to the next used slot. */
+                void skip()
+                {
+                    while( idx < table->capacity && ( table->ctrl[idx] & 0x80 ) )
+                        ++idx;
+                }
+
+            public:
+                /**
+                 * Constructor.
+                 * @param pTable The table.
+                 * @param pIdx   The slot index.
+                 */
+                TIterator( const FlatTypeTable* pTable= nullptr, std::size_t pIdx= 0 )
+                : table( pTable )
+                , idx  ( pIdx   )
+                {}
+
+                /**
+                 * Conversion from mutable to constant iterator. Not available in the opposite
+                 * direction.
+                 * @param other The iterator to copy.
+                 */
+                template<typename TOther,
+                         typename= typename std::enable_if<
+                                       std::is_same<TConstOrMutable, const TOther>::value>::type>
+                TIterator( const TIterator<TOther>& other )
+                : table( other.table )
+                , idx  ( other.idx   )
+                {}
+
+                /** @return The value. */
+                TConstOrMutable& operator* ()                                                  const
+                {
+                    return *reinterpret_cast<TConstOrMutable*>( &table->slots[idx] );
+                }
+
+                /** @return The value. */
+                TConstOrMutable* operator->()                                                  const
+                {
+                    return  reinterpret_cast<TConstOrMutable*>( &table->slots[idx] );
+                }
+
+                /** Prefix increment. @return A reference to this iterator. */
+                TIterator& operator++()
+                {
+                    ++idx;
+                    skip();
+                    return *this;
+                }
+
+                /** Postfix increment. @return The old iterator. */
+                TIterator  operator++(int)
+                {
+                    TIterator result= *this;
+                    ++*this;
+                    return result;
+                }
+
+                /** @param other The iterator to compare. @return \c true if equal. */
+                bool operator==( const TIterator& other )                                      const
+                {
+                    return idx == other.idx;
+                }
+
+                /** @param other The iterator to compare. @return \c true if not equal. */
+                bool operator!=( const TIterator& other )                                      const
+                {
+                    return idx != other.idx;
+                }
+
+                template<typename> friend class TIterator;
+        };
+
+        /** The mutable iterator type. */
+        using iterator      = TIterator<TValue>;
+
+        /** The constant iterator type. */
+        using const_iterator= TIterator<const TValue>;
+
+        /** The key type. */
+        using key_type      = TKey;
+
+        /** The value type. */
+        using value_type    = TValue;
+
+        /** The size type. */
+        using size_type     = std::size_t;
+
+    // ###############################  construction, assignment  ###############################
+    public:
+        /** Default constructor. Does not allocate. */
+        FlatTypeTable()
+        : ctrl      ( nullptr )
+        , slots     ( nullptr )
+        , capacity  ( 0 )
+        , used      ( 0 )
+        , growthLeft( 0 )
+        {}
+
+        /**
+         * Copy constructor.
+         * @param other The table to copy.
+         */
+        FlatTypeTable( const FlatTypeTable& other )
+        : FlatTypeTable()
+        {
+            reserve( other.used );
+            for( const auto& value : other )
+                insertUnique( value );
+        }
+
+        /**
+         * Move constructor.
+         * @param other The table to move.
+         */
+        FlatTypeTable( FlatTypeTable&& other ) noexcept
+        : ctrl      ( other.ctrl       )
+        , slots     ( other.slots      )
+        , capacity  ( other.capacity   )
+        , used      ( other.used       )
+        , growthLeft( other.growthLeft )
+        {
+            other.ctrl      = nullptr;
+            other.slots     = nullptr;
+            other.capacity  = 0;
+            other.used      = 0;
+            other.growthLeft= 0;
+        }
+
+        /**
+         * Assignment.
+         * @param other The table to copy or move.
+         * @return A reference to this table.
+         */
+        FlatTypeTable& operator=( FlatTypeTable other ) noexcept
+        {
+            std::swap( ctrl      , other.ctrl       );
+            std::swap( slots     , other.slots      );
+            std::swap( capacity  , other.capacity   );
+            std::swap( used      , other.used       );
+            std::swap( growthLeft, other.growthLeft );
+            return *this;
+        }
+
+        /** Destructor. */
+        ~FlatTypeTable()
+        {
+            destroyAll();
+            deallocate();
+        }
+
+    // ###############################      interface       ######################################
+    public:
+        /** @return An iterator to the first value. */
+        iterator        begin()           { iterator       it( this, 0 ); it.skip(); return it; }
+
+        /** @return The end iterator. */
+        iterator        end()             { return iterator( this, capacity ); }
+
+        /** @return A constant iterator to the first value. */
+        const_iterator  begin()     const { const_iterator it( this, 0 ); it.skip(); return it; }
+
+        /** @return The constant end iterator. */
+        const_iterator  end()       const { return const_iterator( this, capacity ); }
+
+        /** @return A constant iterator to the first value. */
+        const_iterator  cbegin()    const { return begin(); }
+
+        /** @return The constant end iterator. */
+        const_iterator  cend()      const { return end(); }
+
+        /** @return \c true if the table is empty. */
+        bool            empty()     const { return used == 0; }
+
+        /** @return The number of values. */
+        size_type       size()      const { return used; }
+
+        /** Removes all values. The capacity is kept. */
+        void            clear()
+        {
+            destroyAll();
+            if( capacity != 0 )
+                std::memset( ctrl, Empty, capacity );
+            used      = 0;
+            growthLeft= maxLoad( capacity );
+        }
+
+        /**
+         * Allocates space for the given number of values.
+         * @param qty The number of values to reserve space for.
+         */
+        void            reserve( size_type qty )
+        {
+            if( qty == 0 )
+                return;
+            std::size_t newCapacity= GroupSize;
+            while( maxLoad( newCapacity ) < qty )
+                newCapacity*= 2;
+            if( newCapacity > capacity )
+                rehash( newCapacity );
+        }
+
+        /**
+         * Searches a value.
+         * @param key The key to search.
+         * @return An iterator to the value, #end if not found.
+         */
+        iterator        find( const key_type& key )
+        {
+            return iterator( this, findIndex( key ) );
+        }
+
+        /**
+         * Searches a value.
+         * @param key The key to search.
+         * @return A constant iterator to the value, #end if not found.
+         */
+        const_iterator  find( const key_type& key )                                            const
+        {
+            return const_iterator( this, findIndex( key ) );
+        }
+
+        /**
+         * Counts the values with the given key.
+         * @param key The key to search.
+         * @return \c 1 if found, \c 0 otherwise.
+         */
+        size_type       count( const key_type& key )                                           const
+        {
+            return findIndex( key ) != capacity ? 1 : 0;
+        }
+
+        /**
+         * Inserts a value, unless a value with the same key exists.
+         * @param value The value to insert.
+         * @return A pair of an iterator to the value and a boolean that is \c true if the
+         *         value was inserted.
+         */
+        std::pair<iterator, bool>  insert( const value_type& value )
+        {
+            return emplaceImpl( TKeyOf()( value ), value );
+        }
+
+        /**
+         * Inserts a value, unless a value with the same key exists.
+         * @param value The value to insert.
+         * @return A pair of an iterator to the value and a boolean that is \c true if the
+         *         value was inserted.
+         */
+        std::pair<iterator, bool>  insert( value_type&& value )
+        {
+            return emplaceImpl( TKeyOf()( value ), std::move( value ) );
+        }
+
+        /**
+         * Constructs and inserts a value, unless a value with the same key exists.
+         * @param args The arguments of the value's constructor.
+         * @return A pair of an iterator to the value and a boolean that is \c true if the
+         *         value was inserted.
+         */
+        template<typename... TArgs>
+        std::pair<iterator, bool>  emplace( TArgs&&... args )
+        {
+            return insert( value_type( std::forward<TArgs>( args )... ) );
+        }
+
+        /**
+         * Removes the value with the given key.
+         * @param key The key of the value to remove.
+         * @return \c 1 if a value was removed, \c 0 otherwise.
+         */
+        size_type       erase( const key_type& key )
+        {
+            std::size_t idx= findIndex( key );
+            if( idx == capacity )
+                return 0;
+            eraseAt( idx );
+            return 1;
+        }
+
+        /**
+         * Removes the value the given iterator refers to.
+         * @param pos The iterator to the value to remove.
+         * @return An iterator to the next value.
+         */
+        iterator        erase( const_iterator pos )
+        {
+            eraseAt( pos.idx );
+            iterator next( this, pos.idx + 1 );
+            next.skip();
+            return next;
+        }
+
+    // ###############################    implementation     #####################################
+    protected:
+        /**
+         * Returns the number of values a table of the given capacity holds before it grows.
+         * @param pCapacity The capacity.
+         * @return Seven eighths of \p{pCapacity}.
+         */
+        static std::size_t  maxLoad( std::size_t pCapacity )
+        {
+            return pCapacity - pCapacity / 8;
+        }
+
+        /**
+         * Mixes the hash code of the key, to spread its bits.
+         * @param key The key.
+         * @return The mixed hash code.
+         */
+        static std::size_t  hashOf( const key_type& key )
+        {
+            std::uint64_t hash= static_cast<std::uint64_t>( std::hash<key_type>()( key ) )
+                                * 0x9E3779B97F4A7C15ull;
+            return static_cast<std::size_t>( hash ^ ( hash >> 32 ) );
+        }
+
+        /**
+         * Loads the control bytes of the group starting at \p{idx}.
+         * @param idx The first slot of the group.
+         * @return The control bytes.
+         */
+        std::uint64_t       group( std::size_t idx )                                           const
+        {
+            std::uint64_t result;
+            std::memcpy( &result, ctrl + idx, sizeof(result) );
+            return result;
+        }
+
+        /**
+         * Returns a bitmask with the highest bit set in each byte of \p{group} that equals
+         * \p{h2}. (Might report false positives, behind a true positive.)
+         * @param pGroup The control bytes of a group.
+         * @param h2     The seven hash bits to match.
+         * @return The bitmask.
+         */
+        static std::uint64_t matchByte( std::uint64_t pGroup, std::uint8_t h2 )
+        {
+            std::uint64_t x= pGroup ^ ( 0x0101010101010101ull * h2 );
+            return ( x - 0x0101010101010101ull ) & ~x & 0x8080808080808080ull;
+        }
+
+        /**
+         * Returns a bitmask with the highest bit set in each empty byte of \p{group}.
+         * @param pGroup The control bytes of a group.
+         * @return The bitmask.
+         */
+        static std::uint64_t matchEmpty( std::uint64_t pGroup )
+        {
+            return pGroup & ( ~pGroup << 6 ) & 0x8080808080808080ull;
+        }
+
+        /**
+         * Returns a bitmask with the highest bit set in each empty or deleted byte of \p{group}.
+         * @param pGroup The control bytes of a group.
+         * @return The bitmask.
+         */
+        static std::uint64_t matchEmptyOrDeleted( std::uint64_t pGroup )
+        {
+            return pGroup & ( ~pGroup << 7 ) & 0x8080808080808080ull;
+        }
+
+        /**
+         * Returns the byte index of the lowest bit in \p{mask}. Works on little and big endian.
+         * @param mask A bitmask returned by one of the match methods.
+         * @return The slot index within the group.
+         */
+        static std::size_t  firstIndex( std::uint64_t mask )
+        {
+            #if defined(__GNUC__) && defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+                return static_cast<std::size_t>( __builtin_ctzll( mask ) ) / 8;
+            #endif
+
+            // find the byte of the first slot in memory order
+            std::uint8_t bytes[8];
+            std::memcpy( bytes, &mask, sizeof(mask) );
+            std::size_t idx= 0;
+            while( bytes[idx] == 0 )
+                ++idx;
+            return idx;
+        }
+
+        /**
+         * Removes the lowest byte set in \p{mask} (in memory order).
+         * @param mask A bitmask returned by one of the match methods.
+         * @return The mask with the first match removed.
+         */
+        static std::uint64_t nextMatch( std::uint64_t mask )
+        {
+            #if defined(__GNUC__) && defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+                return mask & ( mask - 1 );
+            #endif
+
+            std::uint8_t bytes[8];
+            std::memcpy( bytes, &mask, sizeof(mask) );
+            bytes[firstIndex( mask )]= 0;
+            std::memcpy( &mask, bytes, sizeof(mask) );
+            return mask;
+        }
+
+        /**
+         * Returns the value stored in the given slot.
+         * @param idx The slot index.
+         * @return The value.
+         */
+        value_type&         valueAt( std::size_t idx )                                         const
+        {
+            return *reinterpret_cast<value_type*>( &slots[idx] );
+        }
+
+        /**
+         * Searches a key.
+         * @param key The key to search.
+         * @return The slot index, #capacity if not found.
+         */
+        std::size_t         findIndex( const key_type& key )                                   const
+        {
+            if( used == 0 )
+                return capacity;
+
+            std::size_t  hash     = hashOf( key );
+            std::uint8_t h2       = static_cast<std::uint8_t>( hash & 0x7F );
+            std::size_t  groupMask= capacity / GroupSize - 1;
+            std::size_t  groupIdx = ( hash >> 7 ) & groupMask;
+            for( std::size_t step= 1 ;; ++step )
+            {
+                std::size_t   first= groupIdx * GroupSize;
+                std::uint64_t ctrls= group( first );
+                for( std::uint64_t match= matchByte( ctrls, h2 ) ; match ; match= nextMatch( match ) )
+                {
+                    std::size_t idx= first + firstIndex( match );
+                    if( std::equal_to<key_type>()( TKeyOf()( valueAt( idx ) ), key ) )
+                        return idx;
+                }
+                if( matchEmpty( ctrls ) )
+                    return capacity;
+                groupIdx= ( groupIdx + step ) & groupMask;
+            }
+        }
+
+        /**
+         * Searches the first empty or deleted slot in the probe sequence of \p{hash}.
+         * @param hash The mixed hash code.
+         * @return The slot index.
+         */
+        std::size_t         findFree( std::size_t hash )                                       const
+        {
+            std::size_t groupMask= capacity / GroupSize - 1;
+            std::size_t groupIdx = ( hash >> 7 ) & groupMask;
+            for( std::size_t step= 1 ;; ++step )
+            {
+                std::uint64_t match= matchEmptyOrDeleted( group( groupIdx * GroupSize ) );
+                if( match )
+                    return groupIdx * GroupSize + firstIndex( match );
+                groupIdx= ( groupIdx + step ) & groupMask;
+            }
+        }
+
+        /**
+         * Inserts a value, unless its key exists.
+         * @param key   The key of the value.
+         * @param args  The arguments to construct the value.
+         * @return A pair of an iterator to the value and a boolean that is \c true if the
+         *         value was inserted.
+         */
+        template<typename... TArgs>
+        std::pair<iterator, bool>   emplaceImpl( const key_type& key, TArgs&&... args )
+        {
+            std::size_t idx= findIndex( key );
+            if( idx != capacity )
+                return std::make_pair( iterator( this, idx ), false );
+
+            return std::make_pair( iterator( this, insertUnique( std::forward<TArgs>( args )... ) ),
+                                   true );
+        }
+
+        /**
+         * Inserts a value whose key is known to be not contained.
+         * @param args The arguments to construct the value.
+         * @return The slot index.
+         */
+        template<typename... TArgs>
+        std::size_t         insertUnique( TArgs&&... args )
+        {
+            // construct first: the key might be a reference into args
+            value_type value( std::forward<TArgs>( args )... );
+            std::size_t hash= hashOf( TKeyOf()( value ) );
+            std::size_t idx = capacity ? findFree( hash ) : 0;
+            if( capacity == 0 || ( growthLeft == 0 && ctrl[idx] == Empty ) )
+            {
+                rehash( capacity == 0               ? GroupSize
+                      : used * 2 < maxLoad( capacity ) ? capacity
+                                                        : capacity * 2 );
+                idx= findFree( hash );
+            }
+
+            new( &slots[idx] ) value_type( std::move( value ) );
+            if( ctrl[idx] == Empty )
+                --growthLeft;
+            ctrl[idx]= static_cast<std::uint8_t>( hash & 0x7F );
+            ++used;
+            return idx;
+        }
+
+        /**
+         * Removes the value in the given slot.
+         * @param idx The slot index.
+         */
+        void                eraseAt( std::size_t idx )
+        {
+            valueAt( idx ).~value_type();
+            --used;
+
+            // groups that are not full do not continue probe sequences
+            if( matchEmpty( group( idx & ~( GroupSize - 1 ) ) ) )
+            {
+                ctrl[idx]= Empty;
+                ++growthLeft;
+            }
+            else
+                ctrl[idx]= Deleted;
+        }
+
+        /**
+         * Moves all values into new storage of the given capacity. Removes deleted slots.
+         * @param newCapacity The new capacity.
+         */
+        void                rehash( std::size_t newCapacity )
+        {
+            std::uint8_t* oldCtrl    = ctrl;
+            Slot*         oldSlots   = slots;
+            std::size_t   oldCapacity= capacity;
+
+            ctrl      = static_cast<std::uint8_t*>( ::operator new( newCapacity ) );
+            slots     = static_cast<Slot*>        ( ::operator new( newCapacity * sizeof(Slot) ) );
+            capacity  = newCapacity;
+            used      = 0;
+            growthLeft= maxLoad( newCapacity );
+            std::memset( ctrl, Empty, newCapacity );
+
+            for( std::size_t idx= 0 ; idx < oldCapacity ; ++idx )
+                if( !( oldCtrl[idx] & 0x80 ) )
+                {
+                    value_type& value= *reinterpret_cast<value_type*>( &oldSlots[idx] );
+                    std::size_t hash = hashOf( TKeyOf()( value ) );
+                    std::size_t newIdx= findFree( hash );
+                    new( &slots[newIdx] ) value_type( std::move( value ) );
+                    value.~value_type();
+                    ctrl[newIdx]= static_cast<std::uint8_t>( hash & 0x7F );
+                    --growthLeft;
+                    ++used;
+                }
+
+            ::operator delete( oldCtrl );
+            ::operator delete( oldSlots );
+        }
+
+        /** Destroys all values. */
+        void                destroyAll()
+        {
+            for( std::size_t idx= 0 ; idx < capacity ; ++idx )
+                if( !( ctrl[idx] & 0x80 ) )
+                    valueAt( idx ).~value_type();
+        }
+
+        /** Frees the storage. */
+        void                deallocate()
+        {
+            ::operator delete( ctrl  );
+            ::operator delete( slots );
+        }
+};
+
+/** Returns the key of a key/value pair. */
+struct FlatTypeMapKeyOf
+{
+    /** @param value The pair. @return The key. */
+    template<typename TPair>
+    const typename TPair::first_type& operator()( const TPair& value )                         const
+    {
+        return value.first;
+    }
+};
+
+/** Returns the value itself. */
+struct FlatTypeSetKeyOf
+{
+    /** @param value The value. @return The value. */
+    template<typename TKey>
+    const TKey& operator()( const TKey& value )                                                const
+    {
+        return value;
+    }
+};
+
+} // namespace aworx::lib[::detail]
+//! @endcond
+
+/** ************************************************************************************************
+ * An open-addressing hash map for type keys, storing its values in contiguous memory.
+ * The interface is compatible with that of \alib{compatibility::std,TypeMap}, which is a
+ * node-based <c>std::unordered_map</c>.
+ *
+ * Lookups probe groups of eight slots, by matching eight control bytes that hold seven bits of
+ * the keys' hash codes at once. Keys are compared only if these bits match.
+ * In contrast to <c>std::unordered_map</c>, references and iterators are invalidated by
+ * insertions that grow the map.
+ *
+ * @tparam T    The type of the objects to map.
+ * @tparam TKey The key type. Defaults to <c>std::reference_wrapper<const std::type_info></c>,
+ *              as used by \alib{compatibility::std,TypeMap}. With \alib{TypeKey}, C++ run-time
+ *              type information is not needed and hashing a key does not process the type name.
+ **************************************************************************************************/
+template<typename T, typename TKey= std::reference_wrapper<const std::type_info>>
+class FlatTypeMap
+: public detail::FlatTypeTable<TKey, std::pair<const TKey, T>, detail::FlatTypeMapKeyOf>
+{
+    /** The base type. */
+    using base= detail::FlatTypeTable<TKey, std::pair<const TKey, T>, detail::FlatTypeMapKeyOf>;
+
+    public:
+        /** The mapped type. */
+        using mapped_type= T;
+
+        /**
+         * Returns the object mapped to \p{key}. If not found, a default constructed object
+         * is inserted.
+         * @param key The key.
+         * @return The mapped object.
+         */
+        T&                  operator[]( const TKey& key )
+        {
+            return base::emplaceImpl( key, key, T() ).first->second;
+        }
+};
+
+/** ************************************************************************************************
+ * An open-addressing hash set for type keys, storing its values in contiguous memory.
+ * The interface is compatible with that of \alib{compatibility::std,TypeSet}, with the exception
+ * that iteration is not ordered.
+ *
+ * See \alib{FlatTypeMap} for details.
+ *
+ * @tparam TKey The key type. Defaults to <c>std::reference_wrapper<const std::type_info></c>,
+ *              as used by \alib{compatibility::std,TypeSet}.
+ **************************************************************************************************/
+template<typename TKey= std::reference_wrapper<const std::type_info>>
+class FlatTypeSet
+: public detail::FlatTypeTable<TKey, const TKey, detail::FlatTypeSetKeyOf>
+{};
+
+} // namespace aworx[::lib]
+
+/// Type alias in namespace #aworx.
+template<typename T, typename TKey= std::reference_wrapper<const std::type_info>>
+using FlatTypeMap=    lib::FlatTypeMap<T, TKey>;
+
+/// Type alias in namespace #aworx.
+template<typename TKey= std::reference_wrapper<const std::type_info>>
+using FlatTypeSet=    lib::FlatTypeSet<TKey>;
+
+} // namespace aworx
+
+#endif // HPP_ALIB_LIB_FLATTYPEMAP
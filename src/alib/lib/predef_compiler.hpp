@@ -105,13 +105,16 @@
 
 
 
-// Windows DLL Import/Export
+// Windows DLL Import/Export. With GCC and Clang, symbols stay visible if code is compiled with
+// option -fvisibility=hidden.
 #if defined( _MSC_VER ) && !defined( ALIB_API_NO_DLL )
     #ifdef ALIB_API_IS_DLL
         #define ALIB_API  __declspec(dllexport)
     #else
         #define ALIB_API  __declspec(dllimport)
     #endif
+#elif defined(__GNUC__) || defined(__clang__)
+    #define ALIB_API  __attribute__((visibility("default")))
 #else
     #define ALIB_API
 #endif
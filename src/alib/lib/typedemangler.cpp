@@ -26,22 +26,184 @@
 #   include <cstring>
 #endif
 
+#if !defined(_GLIBCXX_MUTEX) && !defined(_MUTEX_)
+#   include <mutex>
+#endif
+
+#if !defined(_GLIBCXX_ATOMIC) && !defined(_ATOMIC_)
+#   include <atomic>
+#endif
+
+#if !defined(_GLIBCXX_CSTDINT) && !defined(_CSTDINT_)
+#   include <cstdint>
+#endif
+
 
 namespace aworx { namespace lib {
 
     #if defined(__GNUC__) || defined(__clang__)
 
+        //! @cond NO_DOX
+        namespace {
+
+        /**
+         * Guards insertions into #internedNames.
+         * (Never destructed, as types might be demangled during static de-initialization.)
+         * @return The lock.
+         */
+        std::mutex& internLock()
+        {
+            static std::mutex* lock= new std::mutex();
+            return *lock;
+        }
+
+        /**
+         * An open-addressing hash table of the demangled names, keyed by the addresses of the
+         * mangled names. Lookups are lock-free. Insertions acquire #internLock and publish a
+         * larger copy of the table when it is half full. Tables and names are never freed,
+         * hence threads may still read a replaced table: they then miss only names inserted
+         * later, which are found again while the lock is acquired.
+         *
+         * A type's mangled name may be stored more than once, e.g. in different shared
+         * libraries. Then the type is demangled once per such copy.
+         */
+        struct InternedNames
+        {
+            /** An entry. #mangled is set last, with release semantics. */
+            struct Entry
+            {
+                std::atomic<const char*>    mangled;    ///< The key. \c nullptr if unused.
+                std::atomic<const char*>    demangled;  ///< The demangled name.
+            };
+
+            std::size_t     mask;       ///< The number of entries minus one.
+            std::size_t     usage;      ///< The number of used entries. Modified with the lock.
+            Entry*          entries;    ///< The entries.
+
+            /**
+             * Constructor.
+             * @param capacity The number of entries. A power of 2.
+             */
+            InternedNames( std::size_t capacity )
+            : mask   ( capacity - 1 )
+            , usage  ( 0 )
+            , entries( new Entry[capacity] )
+            {
+                for( std::size_t idx= 0 ; idx < capacity ; ++idx )
+                {
+                    entries[idx].mangled  .store( nullptr, std::memory_order_relaxed );
+                    entries[idx].demangled.store( nullptr, std::memory_order_relaxed );
+                }
+            }
+
+            /**
+             * Returns the entry of \p{mangled} or the unused entry it would be inserted in.
+             * @param mangled The mangled name.
+             * @return The entry.
+             */
+            Entry& Find( const char* mangled )
+            {
+                // a multiplicative mix, as the names are located at addresses of few distinct bits
+                std::size_t idx= static_cast<std::size_t>(
+                                     (   reinterpret_cast<std::uintptr_t>( mangled )
+                                       * static_cast<std::uintptr_t>( 0x9E3779B97F4A7C15ull ) ) >> 16 );
+                for(;; ++idx )
+                {
+                    Entry&      entry= entries[idx & mask];
+                    const char* key  = entry.mangled.load( std::memory_order_acquire );
+                    if( key == mangled || key == nullptr )
+                        return entry;
+                }
+            }
+
+            /**
+             * Inserts a name. Must be invoked only while #internLock is acquired and only if
+             * there is room for it.
+             * @param mangled   The mangled name.
+             * @param demangled The demangled name.
+             */
+            void Insert( const char* mangled, const char* demangled )
+            {
+                Entry& entry= Find( mangled );
+                entry.demangled.store( demangled, std::memory_order_relaxed );
+                entry.mangled  .store( mangled  , std::memory_order_release );
+                ++usage;
+            }
+        };
+
+        /** The current table of demangled names. */
+        std::atomic<InternedNames*> internedNames( nullptr );
+
+        /**
+         * Searches a demangled name without locking.
+         * @param mangled The mangled name.
+         * @return The demangled name, \c nullptr if not interned.
+         */
+        const char* findInterned( const char* mangled )
+        {
+            InternedNames* table= internedNames.load( std::memory_order_acquire );
+            if( table == nullptr )
+                return nullptr;
+
+            InternedNames::Entry& entry= table->Find( mangled );
+            return entry.mangled.load( std::memory_order_relaxed ) == mangled
+                   ? entry.demangled.load( std::memory_order_relaxed )
+                   : nullptr;
+        }
+
+        /**
+         * Inserts a demangled name, growing the table if needed.
+         * Must be invoked only while #internLock is acquired.
+         * @param mangled   The mangled name.
+         * @param demangled The demangled name.
+         */
+        void intern( const char* mangled, const char* demangled )
+        {
+            InternedNames* table= internedNames.load( std::memory_order_relaxed );
+            if( table == nullptr || 2 * ( table->usage + 1 ) > table->mask + 1 )
+            {
+                InternedNames* grown= new InternedNames( table == nullptr ? 64
+                                                                          : 2 * ( table->mask + 1 ) );
+                if( table != nullptr )
+                    for( std::size_t idx= 0 ; idx <= table->mask ; ++idx )
+                    {
+                        InternedNames::Entry& entry= table->entries[idx];
+                        const char*           key  = entry.mangled.load( std::memory_order_relaxed );
+                        if( key != nullptr )
+                            grown->Insert( key, entry.demangled.load( std::memory_order_relaxed ) );
+                    }
+                internedNames.store( grown, std::memory_order_release );
+                table= grown;
+            }
+            table->Insert( mangled, demangled );
+        }
+
+        } // anonymous namespace
+        //! @endcond
+
         DbgTypeDemangler::DbgTypeDemangler( const std::type_info& typeInfo )
         {
+            const char* mangled= typeInfo.name();
+
+            name= findInterned( mangled );
+            if( name != nullptr )
+                return;
+
+            std::lock_guard<std::mutex> guard( internLock() );
+            name= findInterned( mangled );
+            if( name != nullptr )
+                return;
+
             int status;
-            name= abi::__cxa_demangle( typeInfo.name(), nullptr, nullptr, &status);
+            name= abi::__cxa_demangle( mangled, nullptr, nullptr, &status);
             assert( status==0 );
+            if( name == nullptr )
+                name= mangled;
+            intern( mangled, name );
         }
 
         DbgTypeDemangler::~DbgTypeDemangler()
         {
-            if ( name )
-                std::free(static_cast<void*>( const_cast<char*>(name) ) );
         }
 
         const char* DbgTypeDemangler::Get()
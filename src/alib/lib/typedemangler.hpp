@@ -24,6 +24,13 @@ namespace aworx { namespace lib {
 /** ********************************************************************************************
  * Retrieves human readable names from C++ run-time type information.<br>
  * This class is available only in debug compilations of \alib.
+ *
+ * Demangled names are interned in a process-wide, thread-safe cache. Hence each type is
+ * demangled only once, and later constructions for the same type neither demangle, allocate
+ * memory nor acquire a lock. The names remain valid until the process ends.
+ *
+ * Type names that are available at compile-time, also in release compilations and without
+ * run-time type information, are provided with \alib{TypeNameOf}.
  **********************************************************************************************/
 class DbgTypeDemangler
 {
@@ -47,7 +54,8 @@ class DbgTypeDemangler
 
         /** ************************************************************************************
          * Returns the demangled, human readable name of the type which was provided in the
-         * constructor.
+         * constructor. The name is interned and thus remains valid after this object was
+         * destructed.
          * @return The demangled type name.
          **************************************************************************************/
         ALIB_API
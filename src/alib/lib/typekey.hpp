@@ -0,0 +1,490 @@
+// #################################################################################################
+//  ALib C++ Library
+//
+//  Copyright 2013-2019 A-Worx GmbH, Germany
+//  Published under 'Boost Software License' (a free software license, see LICENSE.txt)
+// #################################################################################################
+#ifndef HPP_ALIB_LIB_TYPEKEY
+#define HPP_ALIB_LIB_TYPEKEY 1
+
+
+#if !defined(HPP_ALIB_LIB_PREDEF_COMPILER)
+#   include "alib/lib/predef_compiler.hpp"
+#endif
+
+#if !defined (_GLIBCXX_CSTDDEF) && !defined(_CSTDDEF_)
+    #include <cstddef>
+#endif
+
+#if !defined (_GLIBCXX_CSTRING) && !defined(_CSTRING_)
+    #include <cstring>
+#endif
+
+#if !defined(_GLIBCXX_FUNCTIONAL) && !defined(_FUNCTIONAL_)
+    #include <functional>
+#endif
+
+#if ALIB_CPP17 && !defined(_GLIBCXX_STRING_VIEW) && !defined(_STRING_VIEW_)
+    #include <string_view>
+#endif
+
+
+#if defined(_MSC_VER)
+#   define ALIB_TYPE_SIGNATURE     __FUNCSIG__
+#else
+#   define ALIB_TYPE_SIGNATURE     __PRETTY_FUNCTION__
+#endif
+
+
+namespace aworx { namespace lib {
+
+//! @cond NO_DOX
+namespace detail {
+
+/** A string that is not zero-terminated. */
+struct TypeSignature
+{
+    const char*  Buffer;  ///< The characters.
+    std::size_t  Length;  ///< The number of characters.
+};
+
+/**
+ * Returns the signature of this function, which is instantiated per type. The compiler includes
+ * the type name in the signature. A free function is used, because signatures of member
+ * functions of class templates contain the type name twice with some compilers.
+ * @tparam T The type.
+ * @return The signature, which contains the name of type \p{T} once.
+ */
+template<typename T>
+constexpr TypeSignature typeSignatureOf()
+{
+    return TypeSignature{ ALIB_TYPE_SIGNATURE, sizeof(ALIB_TYPE_SIGNATURE) - 1 };
+}
+
+/**
+ * Provides the signature of a function that is instantiated per type.
+ * @tparam T The type.
+ */
+template<typename T>
+struct TypeSignatureOf
+{
+    /**
+     * Returns the signature of \alib{detail,typeSignatureOf}.
+     * @return The signature, which contains the name of type \p{T}.
+     */
+    static constexpr TypeSignature Get()
+    {
+        return typeSignatureOf<T>();
+    }
+
+    /** An object unique per code entity (and per compilation unit, for module-local types). */
+    static const char Tag;
+};
+
+template<typename T>
+const char TypeSignatureOf<T>::Tag= 0;
+
+// The functions below are C++ 11 constexpr functions, hence they use recursion instead of loops.
+// The recursion depth is kept below the compilers' default limit of 512 for names of up to
+// 8192 characters.
+
+/**
+ * Tests if \p{needle} is found in \p{signature} at position \p{idx}.
+ * @param signature The signature to search in.
+ * @param idx       The position to test.
+ * @param needle    The zero-terminated string to search.
+ * @return \c true if \p{needle} is found at \p{idx}.
+ */
+constexpr bool matchesAt( TypeSignature signature, std::size_t idx, const char* needle )
+{
+    return    *needle == '\0'
+           || (    idx < signature.Length
+                && signature.Buffer[idx] == *needle
+                && matchesAt( signature, idx + 1, needle + 1 ) );
+}
+
+/**
+ * Tests if \p{needle} starts in \p{signature} within the given range of positions.
+ * The range is halved with each recursion.
+ * @param signature The signature to search in.
+ * @param needle    The zero-terminated string to search.
+ * @param begin     The first position to test.
+ * @param end       The position after the last one to test.
+ * @return \c true if \p{needle} is found.
+ */
+constexpr bool contains( TypeSignature signature, const char* needle, std::size_t begin,
+                         std::size_t end )
+{
+    return end - begin <= 1 ? begin < end && matchesAt( signature, begin, needle )
+                            :    contains( signature, needle, begin, begin + ( end - begin ) / 2 )
+                              || contains( signature, needle, begin + ( end - begin ) / 2, end );
+}
+
+/**
+ * Searches the last occurrence of \p{needle} in the \p{signature} that starts before \p{end}.
+ * Used only with short signatures.
+ * @param signature The signature to search in.
+ * @param needle    The zero-terminated string to search.
+ * @param end       The position after the last one to test.
+ * @return The index of the last occurrence, \c signature.Length if not found.
+ */
+constexpr std::size_t lastIndexOf( TypeSignature signature, const char* needle, std::size_t end )
+{
+    return end == 0                               ? signature.Length
+         : matchesAt( signature, end - 1, needle ) ? end - 1
+                                                   : lastIndexOf( signature, needle, end - 1 );
+}
+
+/**
+ * Returns the position of the type name in signatures of \alib{detail,TypeSignatureOf<T>::Get}.
+ * It is detected using the signature of type \c int, which appears last in the signature.
+ * @return The number of characters preceding the type name.
+ */
+constexpr std::size_t namePrefix()
+{
+    return lastIndexOf( TypeSignatureOf<int>::Get(), "int", TypeSignatureOf<int>::Get().Length );
+}
+
+/**
+ * Returns the number of characters following the type name in signatures of
+ * \alib{detail,TypeSignatureOf<T>::Get}.
+ * @return The number of characters following the type name.
+ */
+constexpr std::size_t nameSuffix()
+{
+    return TypeSignatureOf<int>::Get().Length - namePrefix() - 3;
+}
+
+/**
+ * Cuts the type name out of the signature of \alib{detail,TypeSignatureOf<T>::Get}.
+ * @param signature The signature of \alib{detail,TypeSignatureOf<T>::Get}.
+ * @return The type name.
+ */
+constexpr TypeSignature typeNameOf( TypeSignature signature )
+{
+    return TypeSignature{ signature.Buffer + namePrefix(),
+                          signature.Length - namePrefix() - nameSuffix() };
+}
+
+static_assert(    typeNameOf( typeSignatureOf<char>() ).Length      == 4
+               && typeNameOf( typeSignatureOf<char>() ).Buffer[0]   == 'c'
+               && typeNameOf( typeSignatureOf<unsigned char>() ).Length == 13,
+               "Type names are not detected correctly with this compiler" );
+
+/**
+ * Detects names of types that are local to a compilation unit, namely types in anonymous
+ * namespaces, types declared in functions and lambdas. Different such types may share the
+ * same name.
+ * @param name The type name.
+ * @return \c true if the type is local to a compilation unit.
+ */
+constexpr bool isLocalTypeName( TypeSignature name )
+{
+    return    contains( name, "{anonymous}"          , 0, name.Length )    // GCC
+           || contains( name, "(anonymous namespace)", 0, name.Length )    // Clang
+           || contains( name, "`"                    , 0, name.Length )    // MSVC
+           || contains( name, ")::"                  , 0, name.Length )    // function-local types
+           || contains( name, "<lambda"              , 0, name.Length )
+           || contains( name, "lambda at "           , 0, name.Length );
+}
+
+/**
+ * Applies one character to an FNV-1a hash code.
+ * @param hashCode  The hash code.
+ * @param character The character.
+ * @return The new hash code.
+ */
+constexpr std::size_t hashStep( std::size_t hashCode, char character )
+{
+    return   ( hashCode ^ static_cast<unsigned char>( character ) )
+           * ( sizeof(std::size_t) == 8 ? static_cast<std::size_t>( 1099511628211ull )
+                                        : static_cast<std::size_t>( 16777619u        ) );
+}
+
+/**
+ * Applies four characters to an FNV-1a hash code.
+ * @param hashCode  The hash code.
+ * @param chars     The characters.
+ * @return The new hash code.
+ */
+constexpr std::size_t hashStep4( std::size_t hashCode, const char* chars )
+{
+    return hashStep( hashStep( hashStep( hashStep( hashCode, chars[0] ), chars[1] ), chars[2] ),
+                     chars[3] );
+}
+
+/**
+ * Applies sixteen characters to an FNV-1a hash code.
+ * @param hashCode  The hash code.
+ * @param chars     The characters.
+ * @return The new hash code.
+ */
+constexpr std::size_t hashStep16( std::size_t hashCode, const char* chars )
+{
+    return hashStep4( hashStep4( hashStep4( hashStep4( hashCode, chars ), chars + 4 ), chars + 8 ),
+                      chars + 12 );
+}
+
+/**
+ * Computes the FNV-1a hash code of \p{name}, starting at \p{idx}. Sixteen characters are
+ * applied per recursion.
+ * @param name     The type name.
+ * @param idx      The first character to apply.
+ * @param hashCode The hash code of the characters before \p{idx}.
+ * @return The hash code.
+ */
+constexpr std::size_t hashCodeOf( TypeSignature name, std::size_t idx, std::size_t hashCode )
+{
+    return name.Length - idx >= 16
+           ? hashCodeOf( name, idx + 16, hashStep16( hashCode, name.Buffer + idx ) )
+           : idx < name.Length ? hashCodeOf( name, idx + 1, hashStep( hashCode, name.Buffer[idx] ) )
+                               : hashCode;
+}
+
+/**
+ * Computes the FNV-1a hash code of \p{name}.
+ * @param name The type name.
+ * @return The hash code.
+ */
+constexpr std::size_t hashCodeOf( TypeSignature name )
+{
+    return hashCodeOf( name, 0, sizeof(std::size_t) == 8
+                                ? static_cast<std::size_t>( 14695981039346656037ull )
+                                : static_cast<std::size_t>( 2166136261u          ) );
+}
+
+} // namespace aworx::lib[::detail]
+//! @endcond
+
+/** ************************************************************************************************
+ * A key that identifies a C++ type, without using C++ run-time type information.
+ * In contrast to <c>std::type_info</c>, keys are available with compilations that disable RTTI
+ * (e.g. using compiler option <c>-fno-rtti</c>).
+ *
+ * The key is created from the name of the type, which the compiler includes in the signature
+ * of a templated function. Keys are computed at compile-time and are constant-initialized,
+ * also with C++ 11. Hashing a key returns a stored value and comparing two keys compares the
+ * stored hash codes and name pointers. Only keys of the same type that were created in different
+ * code entities need to compare the names. Type names are limited to 8192 characters, due to
+ * the recursion depth of compile-time evaluation.
+ *
+ * Keys of the same type created in different code entities are equal, as long as all code
+ * entities are compiled with the same compiler. An exception are types that are local to a
+ * compilation unit (types in anonymous namespaces, types declared in functions and lambdas):
+ * because different such types may share the same name, their keys are unique per code entity.
+ **************************************************************************************************/
+class TypeKey
+{
+    protected:
+        /** The type name. Not zero-terminated. */
+        const char*     name;
+
+        /** The length of #name. */
+        std::size_t     nameLength;
+
+        /** \c nullptr, or an object unique to the code entity for types that are local to it. */
+        const void*     local;
+
+        /** The hash code of #name. */
+        std::size_t     hashCode;
+
+    public:
+        /**
+         * Constructor. Use #Of to obtain keys.
+         * @param pName       The type name.
+         * @param pNameLength The length of \p{pName}.
+         * @param pLocal      \c nullptr or an object unique per code entity.
+         * @param pHashCode   The hash code of \p{pName}.
+         */
+        constexpr TypeKey( const char* pName, std::size_t pNameLength, const void* pLocal,
+                           std::size_t pHashCode )
+        : name      ( pName       )
+        , nameLength( pNameLength )
+        , local     ( pLocal      )
+        , hashCode  ( pHashCode   )
+        {}
+
+        /**
+         * Returns the key of type \p{T}.
+         * @tparam T The type to receive the key for.
+         * @return The key of type \p{T}.
+         */
+        template<typename T>
+        static const TypeKey&   Of()
+        {
+            static constexpr TypeKey key= create<T>();
+            return key;
+        }
+
+        /**
+         * Returns the hash code of the key.
+         * @return The hash code.
+         */
+        constexpr std::size_t   Hash()                                                         const
+        {
+            return hashCode;
+        }
+
+        /**
+         * Returns the name of the type as given by the compiler.
+         * \attention The name is not zero-terminated. Its length is received with #NameLength.
+         * @return The type name.
+         */
+        constexpr const char*   Name()                                                         const
+        {
+            return name;
+        }
+
+        /**
+         * Returns the length of the type name.
+         * @return The length of the type name returned by #Name.
+         */
+        constexpr std::size_t   NameLength()                                                   const
+        {
+            return nameLength;
+        }
+
+        /**
+         * Returns the object that makes keys of types that are local to a compilation unit
+         * unique.
+         * @return \c nullptr, or an object unique to the code entity that created the key.
+         */
+        constexpr const void*   Local()                                                        const
+        {
+            return local;
+        }
+
+        /**
+         * Compares two keys.
+         * @param other The key to compare with.
+         * @return \c true if both keys denote the same type, \c false otherwise.
+         */
+        bool operator==( const TypeKey& other )                                                const
+        {
+            return    hashCode   == other.hashCode
+                   && local      == other.local
+                   && nameLength == other.nameLength
+                   && (    name == other.name
+                        || std::memcmp( name, other.name, nameLength ) == 0 );
+        }
+
+        /**
+         * Compares two keys.
+         * @param other The key to compare with.
+         * @return \c true if the keys denote different types, \c false otherwise.
+         */
+        bool operator!=( const TypeKey& other )                                                const
+        {
+            return !( *this == other );
+        }
+
+        /**
+         * Defines an arbitrary, but among all code entities consistent, order of keys.
+         * @param other The key to compare with.
+         * @return \c true if this key is ordered before \p{other}, \c false otherwise.
+         */
+        bool operator< ( const TypeKey& other )                                                const
+        {
+            if( hashCode   != other.hashCode   )    return hashCode   < other.hashCode;
+            if( nameLength != other.nameLength )    return nameLength < other.nameLength;
+            int compare= name == other.name ? 0 : std::memcmp( name, other.name, nameLength );
+            if( compare != 0 )                      return compare < 0;
+            return std::less<const void*>()( local, other.local );
+        }
+
+    protected:
+        /**
+         * Creates the key of type \p{T}.
+         * @tparam T The type to create the key for.
+         * @return The key of type \p{T}.
+         */
+        template<typename T>
+        static constexpr TypeKey  create()
+        {
+            return TypeKey( detail::typeNameOf( detail::TypeSignatureOf<T>::Get() ).Buffer,
+                            detail::typeNameOf( detail::TypeSignatureOf<T>::Get() ).Length,
+                            detail::isLocalTypeName( detail::typeNameOf( detail::TypeSignatureOf<T>::Get() ) )
+                              ? &detail::TypeSignatureOf<T>::Tag
+                              : nullptr,
+                            detail::hashCodeOf( detail::typeNameOf( detail::TypeSignatureOf<T>::Get() ) ) );
+        }
+}; // class TypeKey
+
+/** ************************************************************************************************
+ * The name of a type, as returned by \alib{TypeNameOf}. The name is not zero-terminated.
+ **************************************************************************************************/
+struct TypeName
+{
+    const char*  Buffer;  ///< The characters.
+    std::size_t  Length;  ///< The number of characters.
+
+    #if ALIB_CPP17 || ALIB_DOCUMENTATION_PARSER
+        /**
+         * Converts this name to a <c>std::string_view</c>. Available only with C++ 17 and higher.
+         * @return The name.
+         */
+        constexpr operator std::string_view()                                                  const
+        {
+            return std::string_view( Buffer, Length );
+        }
+    #endif
+};
+
+/** ************************************************************************************************
+ * Returns the name of type \p{T}, as the compiler includes it in function signatures.
+ * In contrast to \alib{DbgTypeDemangler}, neither run-time type information nor demangling is
+ * needed and the function is available in release compilations. The name is evaluated at
+ * compile-time.
+ *
+ * The name is a part of a string literal and hence remains valid until the process ends.
+ * It is the same as returned by \alib{TypeKey::Name}. Its format depends on the compiler.
+ * For example, GCC and Clang do not prepend <c>class</c>, while MSVC does.
+ *
+ * @tparam T The type to receive the name for.
+ * @return The type name.
+ **************************************************************************************************/
+template<typename T>
+constexpr TypeName TypeNameOf()
+{
+    return TypeName{ detail::typeNameOf( detail::TypeSignatureOf<T>::Get() ).Buffer,
+                     detail::typeNameOf( detail::TypeSignatureOf<T>::Get() ).Length };
+}
+
+}} // namespace [aworx::lib]
+
+
+#if ALIB_DOCUMENTATION_PARSER
+namespace aworx { namespace lib { namespace compatibility { namespace std {
+#else
+    namespace std {
+#endif
+
+/** ************************************************************************************************
+ * Specialization of functor <c>std::hash</c> for type \alib{TypeKey}.
+ *
+ * This specialization is provided with the inclusion of header file
+ * <c>alib/lib/typekey.hpp</c>.<br>
+ * While the documentation indicates namespace <c>aworx::lib::compatibility::std</c>, the
+ * specialization is (as needed) implemented in namespace <c>std</c>.
+ **************************************************************************************************/
+template<> struct hash<aworx::lib::TypeKey>
+{
+    /**
+     * Returns the (pre-calculated) hash code of the given \p{key}.
+     * @param key  The type key.
+     * @return The hash value
+     */
+    inline
+    std::size_t operator()( const aworx::lib::TypeKey& key ) const
+    {
+        return key.Hash();
+    }
+};
+
+#if ALIB_DOCUMENTATION_PARSER
+}}}} // namespace [aworx::lib::compatibility::std]
+#else
+} // namespace std
+#endif
+
+#endif // HPP_ALIB_LIB_TYPEKEY
@@ -34,6 +34,10 @@
     #include <typeindex>
 #endif
 
+#if !defined(HPP_ALIB_LIB_TYPEKEY)
+#   include "alib/lib/typekey.hpp"
+#endif
+
 
 
 #if ALIB_DOCUMENTATION_PARSER
@@ -162,9 +166,6 @@ using TypeSet= std::set<std::reference_wrapper<const std::type_info>>;
  * Templated type definition for a <c>std::unordered_map</c> that uses key objects of type
  * <c>std::reference_wrapper<const std::type_info></c>.
  *
- * This map is used by \alib internally, for example to store pointers to objects to singletons of
- * the provided type.
- *
  * This type definition, as well as the according specializations of functors <c>std::hash</c>
  * and <c>std::equal_to</c>, are provided with the inclusion of header file
  * <c>alib/lib/typemap.hpp</c>.<br>
@@ -176,6 +177,27 @@ using TypeSet= std::set<std::reference_wrapper<const std::type_info>>;
 template<typename T>
 using TypeMap= std::unordered_map<std::reference_wrapper<const std::type_info>, T>;
 
+/** ************************************************************************************************
+ * Templated type definition for a <c>std::unordered_map</c> that uses key objects of type
+ * \alib{TypeKey}.
+ *
+ * In contrast to \alib{compatibility::std,TypeMap}, hashing a key does not process the type name
+ * and C++ run-time type information is not needed. Keys are obtained with
+ * \alib{TypeKey::Of}.
+ *
+ * This map is used by \alib internally, for example to store pointers to objects to singletons of
+ * the provided type.
+ *
+ * This type definition is provided with the inclusion of header file
+ * <c>alib/lib/typemap.hpp</c>.<br>
+ * While the documentation indicates namespace <c>aworx::lib::compatibility::std</c>, the true
+ * definition is located in namespace <c>aworx</c>.
+ *
+ * @tparam T    The type of the objects to map.
+ **************************************************************************************************/
+template<typename T>
+using TypeKeyMap= std::unordered_map<lib::TypeKey, T>;
+
 #if ALIB_DOCUMENTATION_PARSER
 }}}} // namespace [aworx::lib::compatibility::std]
 #else
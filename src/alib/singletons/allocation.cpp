@@ -0,0 +1,182 @@
+// #################################################################################################
+//  ALib C++ Library
+//
+//  Copyright 2013-2019 A-Worx GmbH, Germany
+//  Published under 'Boost Software License' (a free software license, see LICENSE.txt)
+// #################################################################################################
+#include "alib/singletons/allocation.hpp"
+
+#if !defined (_GLIBCXX_MUTEX) && !defined(_MUTEX_)
+#   include <mutex>
+#endif
+
+#if !defined (_GLIBCXX_CSTDLIB) && !defined(_CSTDLIB_)
+#   include <cstdlib>
+#endif
+
+#if !defined (_GLIBCXX_CSTDINT) && !defined(_CSTDINT_)
+#   include <cstdint>
+#endif
+
+#if !defined (_ASSERT_H) && !defined(assert)
+#   include <assert.h>
+#endif
+
+#if defined(__linux__)
+#   include <sys/mman.h>
+#endif
+
+namespace aworx { namespace lib { namespace singletons {
+
+//! @cond NO_DOX
+
+namespace {
+
+/** The size of a cache line. Singletons in arenas are aligned to and padded to this size. */
+constexpr std::size_t   CacheLineSize=     64;
+
+/** The size of chunks of \c ArenaAllocation. */
+constexpr std::size_t   ChunkSize=         64 * 1024;
+
+/** The size of chunks (and huge pages) of \c HugePageArenaAllocation. */
+constexpr std::size_t   HugePageSize=      2 * 1024 * 1024;
+
+/** The header of a chunk of memory, stored at the start of the chunk. */
+struct ArenaChunk
+{
+    ArenaChunk*     next;       ///< The previously allocated chunk.
+    std::size_t     size;       ///< The size of the chunk. (Only needed with \c mmap).
+    bool            mapped;     ///< Denotes if the chunk was allocated with \c mmap.
+};
+
+/** A bump allocator that allocates chunks of memory. */
+struct Arena
+{
+    ArenaChunk*     chunks;     ///< The list of chunks.
+    char*           fill;       ///< The next free byte in the current chunk.
+    char*           end;        ///< The end of the current chunk.
+};
+
+Arena       arena        = { nullptr, nullptr, nullptr };
+Arena       hugePageArena= { nullptr, nullptr, nullptr };
+std::mutex  arenaLock;
+
+/**
+ * Aligns a pointer upwards.
+ * @param pointer   The pointer.
+ * @param alignment The alignment. Has to be a power of 2.
+ * @return The aligned pointer.
+ */
+char* alignUp( char* pointer, std::size_t alignment )
+{
+    std::uintptr_t address= reinterpret_cast<std::uintptr_t>( pointer );
+    return pointer + ( ( alignment - ( address & ( alignment - 1 ) ) ) & ( alignment - 1 ) );
+}
+
+/**
+ * Allocates a chunk of at least the given size with \c mmap, aligned to and advised to be
+ * backed by huge pages.
+ * @param size The minimum size of the chunk.
+ * @return The chunk, \c nullptr if not supported or \c mmap failed.
+ */
+ArenaChunk* mapChunk( std::size_t size )
+{
+    #if defined(__linux__)
+        size= ( size + HugePageSize - 1 ) & ~( HugePageSize - 1 );
+
+        // map an additional huge page, to be able to trim to an aligned range
+        void* mapped= mmap( nullptr, size + HugePageSize, PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+        if( mapped == MAP_FAILED )
+            return nullptr;
+
+        char* start  = static_cast<char*>( mapped );
+        char* aligned= alignUp( start, HugePageSize );
+        if( aligned != start )
+            munmap( start, static_cast<std::size_t>( aligned - start ) );
+        if( aligned + size != start + size + HugePageSize )
+            munmap( aligned + size, static_cast<std::size_t>( start + HugePageSize - aligned ) );
+
+        #if defined(MADV_HUGEPAGE)
+            madvise( aligned, size, MADV_HUGEPAGE );
+        #endif
+
+        ArenaChunk* chunk= reinterpret_cast<ArenaChunk*>( aligned );
+        chunk->size  = size;
+        chunk->mapped= true;
+        return chunk;
+    #else
+        (void) size;
+        return nullptr;
+    #endif
+}
+
+} // anonymous namespace
+
+void* allocateInArena( std::size_t size, std::size_t alignment, bool hugePages )
+{
+    if( alignment < CacheLineSize )
+        alignment= CacheLineSize;
+    size= ( size + CacheLineSize - 1 ) & ~( CacheLineSize - 1 );
+
+    std::lock_guard<std::mutex> guard( arenaLock );
+    Arena& theArena= hugePages ? hugePageArena : arena;
+
+    char* result= theArena.fill != nullptr ? alignUp( theArena.fill, alignment ) : nullptr;
+    if( result == nullptr || result + size > theArena.end )
+    {
+        // the rest of the current chunk is dropped
+        std::size_t chunkSize= sizeof(ArenaChunk) + alignment + size;
+        ArenaChunk* chunk    = hugePages ? mapChunk( chunkSize ) : nullptr;
+        if( chunk == nullptr )
+        {
+            if( chunkSize < ChunkSize )
+                chunkSize= ChunkSize;
+            chunk= static_cast<ArenaChunk*>( std::malloc( chunkSize ) );
+            if( chunk == nullptr )
+            {
+                assert( false ); // Out of memory
+                std::abort();
+            }
+            chunk->size  = chunkSize;
+            chunk->mapped= false;
+        }
+
+        chunk->next    = theArena.chunks;
+        theArena.chunks= chunk;
+        theArena.fill  = reinterpret_cast<char*>( chunk ) + sizeof(ArenaChunk);
+        theArena.end   = reinterpret_cast<char*>( chunk ) + chunk->size;
+        result         = alignUp( theArena.fill, alignment );
+    }
+
+    theArena.fill= result + size;
+    return result;
+}
+
+void releaseArenas()
+{
+    std::lock_guard<std::mutex> guard( arenaLock );
+    Arena* arenas[]= { &arena, &hugePageArena };
+    for( Arena* theArena : arenas )
+    {
+        while( theArena->chunks != nullptr )
+        {
+            ArenaChunk* chunk= theArena->chunks;
+            theArena->chunks= chunk->next;
+            #if defined(__linux__)
+                if( chunk->mapped )
+                {
+                    munmap( chunk, chunk->size );
+                    continue;
+                }
+            #endif
+            std::free( chunk );
+        }
+        theArena->fill= nullptr;
+        theArena->end = nullptr;
+    }
+}
+
+//! @endcond
+
+}}} // namespace [aworx::lib::singletons]
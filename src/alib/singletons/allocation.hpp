@@ -0,0 +1,295 @@
+// #################################################################################################
+//  ALib C++ Library
+//
+//  Module Singletons
+//
+//  Copyright 2013-2019 A-Worx GmbH, Germany
+//  Published under 'Boost Software License' (a free software license, see LICENSE.txt)
+// #################################################################################################
+#ifndef HPP_ALIB_SINGLETONS_ALLOCATION
+#define HPP_ALIB_SINGLETONS_ALLOCATION 1
+
+#if  !defined(HPP_ALIB_SINGLETONS_PREDEF)
+#   include "alib/singletons/singletons_predef.hpp"
+#endif
+
+#if !defined (_GLIBCXX_NEW) && !defined(_NEW_)
+#   include <new>
+#endif
+
+#if !defined (_GLIBCXX_CSTDDEF) && !defined(_CSTDDEF_)
+#   include <cstddef>
+#endif
+
+#if !defined (_GLIBCXX_CSTDINT) && !defined(_CSTDINT_)
+#   include <cstdint>
+#endif
+
+#if !defined (_GLIBCXX_TYPE_TRAITS) && !defined(_TYPE_TRAITS_)
+#   include <type_traits>
+#endif
+
+#if ALIB_CPP17 && !defined (_GLIBCXX_MEMORY_RESOURCE) && !defined(_MEMORY_RESOURCE_)
+#   include <memory_resource>
+#endif
+
+namespace aworx { namespace lib { namespace singletons {
+
+//! @cond NO_DOX
+extern ALIB_API void*  allocateInArena( std::size_t size, std::size_t alignment, bool hugePages );
+extern ALIB_API void   releaseArenas();
+//! @endcond
+
+/** ************************************************************************************************
+ * Allocation policy for singletons, which allocates them on the heap, using the global
+ * <c>operator new</c>. This is the default policy.
+ *
+ * Over-aligned singletons (for example declared with <c>alignas(64)</c>) are allocated with
+ * the aligned <c>operator new</c> of C++ 17. Below C++ 17, the memory is over-allocated and
+ * aligned by this policy.
+ *
+ * Allocation policies are selected per singleton type by specializing type trait
+ * \alib{singletons,T_SingletonAllocation}.
+ **************************************************************************************************/
+struct HeapAllocation
+{
+    /**
+     * Allocates memory for a singleton.
+     * @param size      The size of the singleton.
+     * @param alignment The alignment of the singleton.
+     * @return The memory.
+     */
+    static void* Allocate( std::size_t size, std::size_t alignment )
+    {
+        #if ALIB_CPP17
+            if( alignment > alignof(std::max_align_t) )
+                return ::operator new( size, std::align_val_t( alignment ) );
+        #else
+            if( alignment > alignof(std::max_align_t) )
+            {
+                // the memory received is stored in front of the aligned memory
+                void*          memory = ::operator new( size + alignment + sizeof(void*) );
+                std::uintptr_t address= (   reinterpret_cast<std::uintptr_t>( memory ) + sizeof(void*)
+                                          + alignment - 1 ) & ~( alignment - 1 );
+                reinterpret_cast<void**>( address )[-1]= memory;
+                return reinterpret_cast<void*>( address );
+            }
+        #endif
+        return ::operator new( size );
+    }
+
+    /**
+     * Frees the memory of a singleton.
+     * @param memory    The memory received with #Allocate.
+     * @param size      The size of the singleton.
+     * @param alignment The alignment of the singleton.
+     */
+    static void  Free( void* memory, std::size_t size, std::size_t alignment )
+    {
+        (void) size;
+        #if ALIB_CPP17
+            if( alignment > alignof(std::max_align_t) )
+            {
+                ::operator delete( memory, std::align_val_t( alignment ) );
+                return;
+            }
+        #else
+            if( alignment > alignof(std::max_align_t) )
+            {
+                ::operator delete( static_cast<void**>( memory )[-1] );
+                return;
+            }
+        #endif
+        ::operator delete( memory );
+    }
+};
+
+/** ************************************************************************************************
+ * Allocation policy for singletons, which places them in a process-wide arena that is dedicated
+ * to singletons. Each singleton starts at a cache line and occupies whole cache lines.
+ * Hence, singletons are placed next to each other, without sharing cache lines with other
+ * objects.
+ *
+ * Memory is freed only with \alib{singletons,DeleteSingletons}, after all singletons
+ * were deleted.
+ * \attention Singletons using this policy must not be deleted with keyword \c delete.
+ **************************************************************************************************/
+struct ArenaAllocation
+{
+    /**
+     * Allocates memory for a singleton.
+     * @param size      The size of the singleton.
+     * @param alignment The alignment of the singleton.
+     * @return The memory.
+     */
+    static void* Allocate( std::size_t size, std::size_t alignment )
+    {
+        return allocateInArena( size, alignment, false );
+    }
+
+    /** Does nothing: the arena is freed as a whole. */
+    static void  Free( void*, std::size_t, std::size_t )
+    {}
+};
+
+/** ************************************************************************************************
+ * Variant of \alib{singletons,ArenaAllocation}, which uses a separate arena that on GNU/Linux
+ * is allocated in chunks of 2 MiB with \c mmap and advised to be backed by transparent huge pages
+ * (<c>madvise(MADV_HUGEPAGE)</c>). This reduces TLB misses when many singletons are accessed
+ * frequently. On other platforms, or if \c mmap fails, this policy behaves like
+ * \alib{singletons,ArenaAllocation}.
+ *
+ * \attention Singletons using this policy must not be deleted with keyword \c delete.
+ **************************************************************************************************/
+struct HugePageArenaAllocation
+{
+    /**
+     * Allocates memory for a singleton.
+     * @param size      The size of the singleton.
+     * @param alignment The alignment of the singleton.
+     * @return The memory.
+     */
+    static void* Allocate( std::size_t size, std::size_t alignment )
+    {
+        return allocateInArena( size, alignment, true );
+    }
+
+    /** Does nothing: the arena is freed as a whole. */
+    static void  Free( void*, std::size_t, std::size_t )
+    {}
+};
+
+#if ALIB_CPP17 || ALIB_DOCUMENTATION_PARSER
+/** ************************************************************************************************
+ * Allocation policy for singletons, which allocates them from a <c>std::pmr::memory_resource</c>.
+ * The resource is received with function \p{TResource}, which is invoked with each allocation
+ * and deallocation and hence has to return the same resource each time.
+ *
+ * \attention Singletons using this policy must not be deleted with keyword \c delete.
+ *
+ * Available only with C++ 17 and higher.
+ * @tparam TResource A function that returns the memory resource.
+ **************************************************************************************************/
+template<std::pmr::memory_resource* (*TResource)()>
+struct MemoryResourceAllocation
+{
+    /**
+     * Allocates memory for a singleton.
+     * @param size      The size of the singleton.
+     * @param alignment The alignment of the singleton.
+     * @return The memory.
+     */
+    static void* Allocate( std::size_t size, std::size_t alignment )
+    {
+        return TResource()->allocate( size, alignment );
+    }
+
+    /**
+     * Frees the memory of a singleton.
+     * @param memory    The memory received with #Allocate.
+     * @param size      The size of the singleton.
+     * @param alignment The alignment of the singleton.
+     */
+    static void  Free( void* memory, std::size_t size, std::size_t alignment )
+    {
+        TResource()->deallocate( memory, size, alignment );
+    }
+};
+#endif
+
+/** ************************************************************************************************
+ * Type trait that selects the allocation policy of singleton type \p{TSingleton}.
+ * The trait inherits the policy. By default, this is \alib{singletons,HeapAllocation}.
+ * Other policies are selected by specializing the trait, preferably using macro
+ * \ref ALIB_SINGLETON_ALLOCATION:
+ *
+ *      class HotConfig : public Singleton<HotConfig> { ... };
+ *      ALIB_SINGLETON_ALLOCATION( HotConfig, aworx::lib::singletons::HugePageArenaAllocation )
+ *
+ * A policy provides two static methods:
+ *
+ *      static void* Allocate( std::size_t size, std::size_t alignment );
+ *      static void  Free    ( void* memory, std::size_t size, std::size_t alignment );
+ *
+ * The specialization has to be visible wherever the singleton is created, which usually means
+ * that it is placed next to the declaration of the singleton type.
+ *
+ * @tparam TSingleton The singleton type.
+ **************************************************************************************************/
+template<typename TSingleton>
+struct T_SingletonAllocation : HeapAllocation
+{};
+
+/** ************************************************************************************************
+ * Type trait that selects static storage for singleton type \p{TSingleton}. If the trait
+ * inherits \c std::true_type, the singleton is not allocated, but placed in an object with static
+ * storage duration, which is initialized at compile-time. Then:
+ * - The first access does not allocate memory and does not invoke a constructor.
+ * - In unmapped mode, \alib{singletons,Singleton::GetSingleton} costs a single load, without a
+ *   test for \c nullptr. (With mapped mode, the object is stored in the registry, like any
+ *   singleton, because code entities that do not share symbols have their own copy of it. The
+ *   one that requests the singleton first provides it to the others.)
+ * - The singleton is never destructed. \alib{singletons,DeleteSingletons} removes it from the
+ *   registry only, hence a later request receives the same object in the state it was left.
+ *
+ * By default, static storage is selected for types that are trivially default constructible
+ * and trivially destructible and that use the default allocation policy
+ * \alib{singletons,HeapAllocation}. For these, it is safe: initialization is zero-initialization
+ * at compile-time and no destructor is skipped. (Only \alib{singletons,PlainSingleton} types
+ * qualify, as the polymorphic \alib{singletons,Singleton} has a virtual destructor.) Note that
+ * such a singleton is not reset by \alib{singletons,DeleteSingletons}.
+ *
+ * Otherwise, static storage changes the life cycle of the singleton: its destructor is not
+ * invoked and it is not re-created after \alib{singletons,DeleteSingletons}. Types with a
+ * \c constexpr default constructor may select it by specializing the trait, preferably using
+ * macro \ref ALIB_SINGLETON_STATIC_STORAGE:
+ *
+ *      class Limits : public PlainSingleton<Limits>
+ *      {
+ *          public:
+ *              int MaxConnections;
+ *              constexpr Limits() : MaxConnections( 64 ) {}
+ *      };
+ *      ALIB_SINGLETON_STATIC_STORAGE( Limits )
+ *
+ * \attention
+ *   The trait must not be specialized for types whose default constructor is not \c constexpr.
+ *   Such an object would be constructed with the dynamic initialization of the code entity, in
+ *   undefined order with other objects, and might be accessed before. With C++ 20, this is
+ *   detected at compile-time.
+ *
+ * @tparam TSingleton The singleton type.
+ **************************************************************************************************/
+template<typename TSingleton>
+struct T_SingletonStaticStorage
+: std::integral_constant<bool,    std::is_trivially_default_constructible<TSingleton>::value
+                               && std::is_trivially_destructible         <TSingleton>::value
+                               && std::is_base_of<HeapAllocation,
+                                                  T_SingletonAllocation<TSingleton>>::value>
+{};
+
+}}} // namespace [aworx::lib::singletons]
+
+/**
+ * Specializes type trait \alib{singletons,T_SingletonAllocation} for singleton type
+ * \p{TSingleton}. Has to be placed in the global namespace.
+ * @param TSingleton  The singleton type.
+ * @param TAllocation The allocation policy.
+ */
+#define ALIB_SINGLETON_ALLOCATION( TSingleton, TAllocation )                                       \
+namespace aworx { namespace lib { namespace singletons {                                           \
+template<> struct T_SingletonAllocation<TSingleton> : TAllocation {};                              \
+}}}
+
+/**
+ * Specializes type trait \alib{singletons,T_SingletonStaticStorage} for singleton type
+ * \p{TSingleton}, which has to have a \c constexpr or trivial default constructor. Has to be
+ * placed in the global namespace.
+ * @param TSingleton  The singleton type.
+ */
+#define ALIB_SINGLETON_STATIC_STORAGE( TSingleton )                                                \
+namespace aworx { namespace lib { namespace singletons {                                           \
+template<> struct T_SingletonStaticStorage<TSingleton> : std::true_type {};                        \
+}}}
+
+#endif // HPP_ALIB_SINGLETONS_ALLOCATION
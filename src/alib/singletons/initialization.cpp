@@ -0,0 +1,297 @@
+// #################################################################################################
+//  ALib C++ Library
+//
+//  Copyright 2013-2019 A-Worx GmbH, Germany
+//  Published under 'Boost Software License' (a free software license, see LICENSE.txt)
+// #################################################################################################
+#include "alib/singletons/initialization.hpp"
+
+#if !defined(HPP_ALIB_LIB_FLATTYPEMAP)
+#   include "alib/lib/flattypemap.hpp"
+#endif
+
+#if !defined (_GLIBCXX_MUTEX) && !defined(_MUTEX_)
+#   include <mutex>
+#endif
+
+#if !defined (_GLIBCXX_CONDITION_VARIABLE) && !defined(_CONDITION_VARIABLE_)
+#   include <condition_variable>
+#endif
+
+#if !defined (_GLIBCXX_THREAD) && !defined(_THREAD_)
+#   include <thread>
+#endif
+
+#if !defined (_GLIBCXX_VECTOR) && !defined(_VECTOR_)
+#   include <vector>
+#endif
+
+#if !defined (_GLIBCXX_STRING) && !defined(_STRING_)
+#   include <string>
+#endif
+
+#if !defined (_GLIBCXX_UNORDERED_MAP) && !defined(_UNORDERED_MAP_)
+#   include <unordered_map>
+#endif
+
+#if !defined (_GLIBCXX_ALGORITHM) && !defined(_ALGORITHM_)
+#   include <algorithm>
+#endif
+
+#if !defined (_GLIBCXX_CSTDIO) && !defined(_CSTDIO_)
+#   include <cstdio>
+#endif
+
+#if !defined (_ASSERT_H) && !defined(assert)
+#   include <assert.h>
+#endif
+
+namespace aworx { namespace lib { namespace singletons {
+
+//! @cond NO_DOX
+
+// defined in singleton.cpp
+extern SingletonRegistration*   singletonRegistrations;
+extern std::mutex               singletonRegistrationsLock;
+#if ALIB_FEAT_SINGLETON_MAPPED
+extern void                     visitSingletonCreations( void (*visitor)( const TypeKey&, std::size_t,
+                                                                          std::thread::id, void* ),
+                                                         void* data );
+#endif
+
+SingletonRegistration::SingletonRegistration( KeyFunction type, Creator create,
+                                              const KeyFunction* dependencies )
+: Type        ( type         )
+, Create      ( create       )
+, Dependencies( dependencies )
+{
+    std::lock_guard<std::mutex> guard( singletonRegistrationsLock );
+    next= singletonRegistrations;
+    singletonRegistrations= this;
+}
+
+SingletonRegistration::~SingletonRegistration()
+{
+    std::lock_guard<std::mutex> guard( singletonRegistrationsLock );
+    SingletonRegistration** it= &singletonRegistrations;
+    while( *it != this )
+        it= &(*it)->next;
+    *it= next;
+}
+
+namespace {
+
+/** A node of the dependency graph built by InitializeSingletons. */
+struct InitNode
+{
+    SingletonRegistration*  registration;   ///< The registration.
+    std::size_t             missing;        ///< The number of dependencies not created, yet.
+    std::vector<std::size_t> dependents;    ///< The nodes depending on this one.
+};
+
+/**
+ * Creates the singletons of the given nodes on a pool of threads. Nodes are created in their
+ * order, unless they have to wait for dependencies.
+ * @param nodes       The nodes. Dependencies on types not found in \p{index} are ignored.
+ * @param index       The index of each node's type.
+ * @param threadCount The number of threads to use. If \c 0, the number of hardware threads
+ *                    is used.
+ */
+void createSingletons( std::vector<InitNode>&                          nodes,
+                       const FlatTypeMap<std::size_t, lib::TypeKey>&   index,
+                       unsigned int                                    threadCount )
+{
+    for( std::size_t idx= 0 ; idx < nodes.size() ; ++idx )
+        for( auto* dependency= nodes[idx].registration->Dependencies ; *dependency ; ++dependency )
+        {
+            auto it= index.find( (*dependency)() );
+            if( it == index.end() || it->second == idx )
+                continue;
+            nodes[it->second].dependents.push_back( idx );
+            ++nodes[idx].missing;
+        }
+
+    std::vector<std::size_t> ready;
+    for( std::size_t idx= nodes.size() ; idx > 0 ; --idx )
+        if( nodes[idx - 1].missing == 0 )
+            ready.push_back( idx - 1 );
+
+    // create the singletons on a pool of threads
+    std::mutex              lock;
+    std::condition_variable changed;
+    std::size_t             inProgress= 0;
+    auto worker= [&]()
+    {
+        std::unique_lock<std::mutex> guard( lock );
+        for(;;)
+        {
+            while( ready.empty() && inProgress > 0 )
+                changed.wait( guard );
+
+            // all created, or the remaining nodes are cyclic
+            if( ready.empty() )
+                return;
+
+            InitNode& node= nodes[ready.back()];
+            ready.pop_back();
+            ++inProgress;
+
+            guard.unlock();
+            node.registration->Create();
+            guard.lock();
+
+            --inProgress;
+            node.missing= static_cast<std::size_t>( -1 );
+            for( std::size_t dependent : node.dependents )
+                if( --nodes[dependent].missing == 0 )
+                    ready.push_back( dependent );
+            changed.notify_all();
+        }
+    };
+
+    if( threadCount == 0 )
+        threadCount= std::thread::hardware_concurrency();
+    if( threadCount > nodes.size() )
+        threadCount= static_cast<unsigned int>( nodes.size() );
+
+    std::vector<std::thread> threads;
+    for( unsigned int i= 1 ; i < threadCount ; ++i )
+        threads.emplace_back( worker );
+    worker();
+    for( auto& thread : threads )
+        thread.join();
+
+    // create singletons with cyclic dependencies
+    for( auto& node : nodes )
+        if( node.missing != static_cast<std::size_t>( -1 ) )
+        {
+            assert( false ); // Cyclic dependencies of registered singletons
+            node.registration->Create();
+        }
+}
+
+/**
+ * Reads a line of a file.
+ * @param file The file.
+ * @param line Receives the line, without the line feed.
+ * @return \c false if the end of the file was reached before reading any character.
+ */
+bool readLine( std::FILE* file, std::string& line )
+{
+    line.clear();
+    char buffer[256];
+    while( std::fgets( buffer, sizeof(buffer), file ) != nullptr )
+    {
+        line+= buffer;
+        if( line.back() == '\n' )
+        {
+            line.pop_back();
+            return true;
+        }
+    }
+    return !line.empty();
+}
+
+} // anonymous namespace
+
+//! @endcond
+
+void InitializeSingletons( unsigned int threadCount )
+{
+    // build the dependency graph. Types registered more than once (e.g. by different
+    // code entities) are considered once.
+    std::vector<InitNode>                   nodes;
+    FlatTypeMap<std::size_t, lib::TypeKey>  index;
+    {
+        std::lock_guard<std::mutex> guard( singletonRegistrationsLock );
+        for( SingletonRegistration* it= singletonRegistrations ; it != nullptr ; it= it->next )
+            if( index.emplace( it->Type(), nodes.size() ).second )
+                nodes.push_back( InitNode{ it, 0, std::vector<std::size_t>() } );
+    }
+
+    createSingletons( nodes, index, threadCount );
+}
+
+#if ALIB_FEAT_SINGLETON_MAPPED
+bool WriteSingletonManifest( const char* path )
+{
+    struct Creation
+    {
+        const TypeKey*  type;       ///< The singleton's type.
+        std::size_t     sequence;   ///< The creation order.
+        std::thread::id creator;    ///< The creating thread.
+    };
+
+    std::vector<Creation> creations;
+    visitSingletonCreations( []( const TypeKey& type, std::size_t sequence, std::thread::id creator,
+                                 void* data )
+                             {
+                                 static_cast<std::vector<Creation>*>( data )->push_back(
+                                     Creation{ &type, sequence, creator } );
+                             },
+                             &creations );
+    std::sort( creations.begin(), creations.end(),
+               []( const Creation& lhs, const Creation& rhs )
+               {
+                   return lhs.sequence < rhs.sequence;
+               } );
+
+    std::FILE* file= std::fopen( path, "w" );
+    if( file == nullptr )
+        return false;
+
+    std::fputs( "# ALib singleton manifest: <thread> <type>\n", file );
+    std::vector<std::thread::id> threads;
+    for( const Creation& creation : creations )
+    {
+        std::size_t thread= static_cast<std::size_t>(
+            std::find( threads.begin(), threads.end(), creation.creator ) - threads.begin() );
+        if( thread == threads.size() )
+            threads.push_back( creation.creator );
+        std::fprintf( file, "%zu %.*s\n", thread, static_cast<int>( creation.type->NameLength() ),
+                      creation.type->Name() );
+    }
+
+    bool result= !std::ferror( file );
+    return std::fclose( file ) == 0 && result;
+}
+#endif
+
+std::size_t PrewarmSingletons( const char* path, unsigned int threadCount )
+{
+    std::FILE* file= std::fopen( path, "r" );
+    if( file == nullptr )
+        return 0;
+
+    // registered types by name
+    std::unordered_map<std::string, SingletonRegistration*> registrations;
+    {
+        std::lock_guard<std::mutex> guard( singletonRegistrationsLock );
+        for( SingletonRegistration* it= singletonRegistrations ; it != nullptr ; it= it->next )
+            registrations.emplace( std::string( it->Type().Name(), it->Type().NameLength() ), it );
+    }
+
+    // the listed types that are registered, in order of the manifest
+    std::vector<InitNode>                   nodes;
+    FlatTypeMap<std::size_t, lib::TypeKey>  index;
+    std::string                             line;
+    while( readLine( file, line ) )
+    {
+        if( line.empty() || line[0] == '#' )
+            continue;
+
+        std::size_t separator= line.find( ' ' );
+        if( separator == std::string::npos )
+            continue;
+
+        auto it= registrations.find( line.substr( separator + 1 ) );
+        if( it != registrations.end() && index.emplace( it->second->Type(), nodes.size() ).second )
+            nodes.push_back( InitNode{ it->second, 0, std::vector<std::size_t>() } );
+    }
+    std::fclose( file );
+
+    createSingletons( nodes, index, threadCount );
+    return nodes.size();
+}
+
+}}} // namespace [aworx::lib::singletons]
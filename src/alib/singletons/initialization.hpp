@@ -0,0 +1,189 @@
+// #################################################################################################
+//  ALib C++ Library
+//
+//  Module Singletons
+//
+//  Copyright 2013-2019 A-Worx GmbH, Germany
+//  Published under 'Boost Software License' (a free software license, see LICENSE.txt)
+// #################################################################################################
+#ifndef HPP_ALIB_SINGLETONS_INITIALIZATION
+#define HPP_ALIB_SINGLETONS_INITIALIZATION 1
+
+#if !defined (HPP_ALIB_SINGLETONS_SINGLETON)
+#   include "alib/singletons/singleton.hpp"
+#endif
+
+#if !defined(HPP_ALIB_LIB_TYPEKEY)
+#   include "alib/lib/typekey.hpp"
+#endif
+
+namespace aworx { namespace lib { namespace singletons {
+
+/** ************************************************************************************************
+ * A record that registers a singleton type for eager initialization with
+ * #InitializeSingletons. Records are not created directly, but by defining a (static) instance
+ * of derived type \alib{singletons,RegisterSingleton}.
+ *
+ * Records are linked into a process-wide list when constructed and unlinked when destructed.
+ * No memory is allocated, hence records may be created during static initialization.
+ **************************************************************************************************/
+class SingletonRegistration
+{
+    public:
+        /** Function type that returns the key of a type. */
+        using KeyFunction=  const TypeKey& (*)();
+
+        /** Function type that creates a singleton. */
+        using Creator=      void (*)();
+
+        /** The key of the registered singleton type. */
+        const KeyFunction   Type;
+
+        /** Creates the singleton. */
+        const Creator       Create;
+
+        /** The keys of the types the singleton depends on, terminated by \c nullptr. */
+        const KeyFunction*  Dependencies;
+
+        /** The next registration in the process-wide list. */
+        SingletonRegistration*  next;
+
+    protected:
+        /**
+         * Constructor. Links this record into the process-wide list.
+         * @param type          The key of the registered singleton type.
+         * @param create        Creates the singleton.
+         * @param dependencies  The keys of the types the singleton depends on,
+         *                      terminated by \c nullptr.
+         */
+        ALIB_API
+        SingletonRegistration( KeyFunction type, Creator create, const KeyFunction* dependencies );
+
+        /** Destructor. Unlinks this record from the process-wide list. */
+        ALIB_API
+        ~SingletonRegistration();
+
+    private:
+        /** Deleted copy constructor. */
+        SingletonRegistration( const SingletonRegistration& )= delete;
+
+        /** Deleted copy assignment. */
+        SingletonRegistration& operator=( const SingletonRegistration& )= delete;
+};
+
+/** ************************************************************************************************
+ * Registers singleton type \p{TSingleton} for eager initialization with #InitializeSingletons.
+ * A static instance of this type has to be defined, for example:
+ *
+ *      class Config : public Singleton<Config> { ... };
+ *      class Router : public Singleton<Router> { ... };   // uses Config in its constructor
+ *
+ *      RegisterSingleton<Config>           registerConfig;
+ *      RegisterSingleton<Router, Config>   registerRouter;
+ *
+ * @tparam TSingleton    The singleton type, derived from \alib{singletons,Singleton}.
+ * @tparam TDependencies The singleton types that \p{TSingleton} depends on. These are created
+ *                       before \p{TSingleton}, if they are registered as well.
+ **************************************************************************************************/
+template<typename TSingleton, typename... TDependencies>
+class RegisterSingleton : public SingletonRegistration
+{
+    protected:
+        /** The keys of the dependencies, terminated by \c nullptr. */
+        static constexpr KeyFunction    dependencies[]= { &TypeKey::Of<TDependencies>..., nullptr };
+
+        /** Creates the singleton. */
+        static void create()
+        {
+            TSingleton::GetSingleton();
+        }
+
+    public:
+        /** Constructor. Registers the singleton type. */
+        RegisterSingleton()
+        : SingletonRegistration( &TypeKey::Of<TSingleton>, &create, dependencies )
+        {}
+};
+
+//! @cond NO_DOX
+template<typename TSingleton, typename... TDependencies>
+constexpr SingletonRegistration::KeyFunction
+RegisterSingleton<TSingleton, TDependencies...>::dependencies[];
+//! @endcond
+
+/** ************************************************************************************************
+ * Creates all singletons registered with \alib{singletons,RegisterSingleton}, using the given
+ * number of threads (including the calling thread).
+ *
+ * A singleton is created only after all of its registered dependencies are created.
+ * Independent singletons are created in parallel. Dependencies on types that are not registered
+ * are ignored: such singletons are created lazily, as usual, when requested by a constructor.
+ *
+ * After this method returns, method \alib{singletons,Singleton::GetSingleton} of the registered
+ * types performs a single load.
+ *
+ * \note
+ *   If the declared dependencies are cyclic, an assertion is raised in debug-compilations.
+ *   In release-compilations, the remaining singletons are created sequentially.
+ *
+ * @param threadCount The number of threads to use. If \c 0, the number of hardware threads
+ *                    is used.
+ **************************************************************************************************/
+ALIB_API void  InitializeSingletons( unsigned int threadCount= 0 );
+
+#if ALIB_FEAT_SINGLETON_MAPPED || ALIB_DOCUMENTATION_PARSER
+/** ************************************************************************************************
+ * Writes a manifest of the singletons that currently exist to the file \p{path}. The manifest
+ * lists the types in order of their creation, together with an index of the creating thread.
+ * Indices are given in order of the threads' first creation of a singleton.
+ *
+ * The manifest is a text file. It starts with a comment line, followed by one line per type,
+ * holding the thread index and the type name (see \alib{TypeKey::Name}), separated by a space.
+ *
+ * With the next start of the process, function \alib{singletons,PrewarmSingletons} creates the
+ * recorded singletons in parallel. Hence, a manifest is usually written once startup is
+ * completed, or before \alib{singletons,DeleteSingletons} is invoked on termination.
+ *
+ * \note
+ *   This method is available only if code selection symbol \ref ALIB_FEAT_SINGLETON_MAPPED
+ *   evaluates to true.
+ *
+ * @param path The path of the manifest file.
+ * @return \c true on success, \c false if the file could not be written.
+ **************************************************************************************************/
+ALIB_API bool  WriteSingletonManifest( const char* path );
+#endif
+
+/** ************************************************************************************************
+ * Creates the singletons listed in the manifest file \p{path}, which was written with
+ * \alib{singletons,WriteSingletonManifest}, using the given number of threads (including the
+ * calling thread).
+ *
+ * Types are identified by name and can be created only if they are registered with
+ * \alib{singletons,RegisterSingleton}. Other types listed are ignored, as are registered types
+ * that are not listed. The singletons are created in the recorded order, while
+ * registered dependencies are respected as with \alib{singletons,InitializeSingletons}.
+ * Singletons that are created by constructors are awaited, if they are created by
+ * another thread already. The recorded thread indices are not used to distribute the types
+ * to threads.
+ *
+ * As type names are given by the compiler, a manifest is valid only for processes that are
+ * compiled with the same compiler as the process that wrote it.
+ *
+ * @param path        The path of the manifest file.
+ * @param threadCount The number of threads to use. If \c 0, the number of hardware threads
+ *                    is used.
+ * @return The number of listed types that were found registered and hence were created.
+ *         \c 0 if the file could not be read.
+ **************************************************************************************************/
+ALIB_API std::size_t  PrewarmSingletons( const char* path, unsigned int threadCount= 0 );
+
+}} // namespace aworx[::lib::singletons]
+
+/// Type alias in namespace #aworx.
+template<typename TSingleton, typename... TDependencies>
+using RegisterSingleton=    aworx::lib::singletons::RegisterSingleton<TSingleton, TDependencies...>;
+
+} // namespace aworx
+
+#endif // HPP_ALIB_SINGLETONS_INITIALIZATION
@@ -0,0 +1,268 @@
+// #################################################################################################
+//  ALib C++ Library
+//
+//  Copyright 2013-2019 A-Worx GmbH, Germany
+//  Published under 'Boost Software License' (a free software license, see LICENSE.txt)
+// #################################################################################################
+#include "alib/singletons/replicatedsingleton.hpp"
+
+#if !defined (_GLIBCXX_VECTOR) && !defined(_VECTOR_)
+#   include <vector>
+#endif
+
+#if !defined (_GLIBCXX_STRING) && !defined(_STRING_)
+#   include <string>
+#endif
+
+#if !defined (_GLIBCXX_THREAD) && !defined(_THREAD_)
+#   include <thread>
+#endif
+
+#if defined(__linux__)
+#   include <cstdio>
+#   include <pthread.h>
+#   include <sched.h>
+#   include <sys/mman.h>
+#   include <sys/syscall.h>
+#   include <unistd.h>
+#endif
+
+namespace aworx { namespace lib { namespace singletons {
+
+//! @cond NO_DOX
+
+namespace {
+
+/** The NUMA nodes that have CPUs. */
+struct NumaTopology
+{
+    std::vector<int>                nodeIds;    ///< The identifier of each node.
+    std::vector<std::vector<int>>   nodeCpus;   ///< The CPUs of each node.
+    std::vector<std::size_t>        cpuNodes;   ///< The node index of each CPU.
+};
+
+#if defined(__linux__)
+
+/** The policy of \c set_mempolicy that prefers allocations on the given node. */
+constexpr int MemoryPolicyPreferred= 1; // MPOL_PREFERRED
+
+/**
+ * Reads the first line of a file.
+ * @param path   The path of the file.
+ * @param result Receives the line.
+ * @return \c true on success.
+ */
+bool readLine( const std::string& path, std::string& result )
+{
+    std::FILE* file= std::fopen( path.c_str(), "r" );
+    if( file == nullptr )
+        return false;
+
+    char buffer[4096];
+    bool success= std::fgets( buffer, sizeof(buffer), file ) != nullptr;
+    std::fclose( file );
+    if( success )
+        result= buffer;
+    return success;
+}
+
+/**
+ * Parses a list of numbers and ranges as used by sysfs, for example <c>"0-3,8-11"</c>.
+ * @param text   The list.
+ * @param result Receives the numbers.
+ * @return \c true on success.
+ */
+bool parseList( const std::string& text, std::vector<int>& result )
+{
+    const char* c= text.c_str();
+    while( *c != '\0' && *c != '\n' )
+    {
+        char* end;
+        long first= std::strtol( c, &end, 10 );
+        long last = first;
+        if( end == c || first < 0 )
+            return false;
+        c= end;
+        if( *c == '-' )
+        {
+            last= std::strtol( ++c, &end, 10 );
+            if( end == c || last < first )
+                return false;
+            c= end;
+        }
+        for( long value= first ; value <= last ; ++value )
+            result.push_back( static_cast<int>( value ) );
+        if( *c == ',' )
+            ++c;
+    }
+    return true;
+}
+
+/**
+ * Reads the nodes that have CPUs.
+ * @param directory The sysfs directory of the nodes.
+ * @param topology  Receives the nodes.
+ * @return \c true on success.
+ */
+bool readNodes( const std::string& directory, NumaTopology& topology )
+{
+    std::string      line;
+    std::vector<int> online;
+    if( !readLine( directory + "/online", line ) || !parseList( line, online ) )
+        return false;
+
+    for( int node : online )
+    {
+        std::vector<int> cpus;
+        if(    !readLine( directory + "/node" + std::to_string( node ) + "/cpulist", line )
+            || !parseList( line, cpus ) )
+            return false;
+
+        // nodes without CPUs (memory expansion) are not used
+        if( cpus.empty() )
+            continue;
+
+        topology.nodeIds .push_back( node );
+        topology.nodeCpus.push_back( cpus );
+    }
+    return !topology.nodeIds.empty();
+}
+
+#endif // defined(__linux__)
+
+/**
+ * Reads the topology. Falls back to a single node, if the topology is not available.
+ * @return The topology.
+ */
+NumaTopology readTopology()
+{
+    NumaTopology topology;
+    #if defined(__linux__)
+        if( readNodes( "/sys/devices/system/node", topology ) && topology.nodeIds.size() > 1 )
+        {
+            for( std::size_t idx= 0 ; idx < topology.nodeCpus.size() ; ++idx )
+                for( int cpu : topology.nodeCpus[idx] )
+                {
+                    if( topology.cpuNodes.size() <= static_cast<std::size_t>( cpu ) )
+                        topology.cpuNodes.resize( static_cast<std::size_t>( cpu ) + 1, 0 );
+                    topology.cpuNodes[static_cast<std::size_t>( cpu )]= idx;
+                }
+            return topology;
+        }
+    #endif
+
+    topology.nodeIds .assign( 1, 0 );
+    topology.nodeCpus.assign( 1, std::vector<int>() );
+    topology.cpuNodes.clear();
+    return topology;
+}
+
+/**
+ * Returns the topology, which is read once.
+ * @return The topology.
+ */
+const NumaTopology& topology()
+{
+    static NumaTopology theTopology= readTopology();
+    return theTopology;
+}
+
+#if defined(__linux__)
+
+/**
+ * Creates the node mask of a node, as used by \c set_mempolicy and \c mbind. The kernel reads
+ * one bit less than the \c maxnode argument, which hence is <c>sizeof(mask) * 8 + 1</c>.
+ * @param node The index of the node.
+ * @param mask Receives the mask.
+ * @return \c false if the node identifier exceeds the mask.
+ */
+bool nodeMask( std::size_t node, unsigned long& mask )
+{
+    int nodeId= topology().nodeIds[node];
+    if( nodeId >= static_cast<int>( sizeof(unsigned long) * 8 ) )
+        return false;
+    mask= 1ul << nodeId;
+    return true;
+}
+
+#endif // defined(__linux__)
+
+} // anonymous namespace
+
+std::size_t  numaNodeCount()
+{
+    return topology().nodeIds.size();
+}
+
+std::size_t  currentNumaNode()
+{
+    #if defined(__linux__)
+        const NumaTopology& theTopology= topology();
+        int cpu= sched_getcpu();
+        if( cpu >= 0 && static_cast<std::size_t>( cpu ) < theTopology.cpuNodes.size() )
+            return theTopology.cpuNodes[static_cast<std::size_t>( cpu )];
+    #endif
+    return 0;
+}
+
+void  runOnNumaNode( std::size_t node, void (*task)( void* ), void* data )
+{
+    if( numaNodeCount() == 1 )
+    {
+        task( data );
+        return;
+    }
+
+    std::thread thread( [node, task, data]()
+    {
+        #if defined(__linux__)
+            const NumaTopology& theTopology= topology();
+
+            // failures are ignored: the task then runs on any node
+            cpu_set_t cpus;
+            CPU_ZERO( &cpus );
+            for( int cpu : theTopology.nodeCpus[node] )
+                if( cpu < CPU_SETSIZE )
+                    CPU_SET( cpu, &cpus );
+            pthread_setaffinity_np( pthread_self(), sizeof(cpus), &cpus );
+
+            unsigned long mask;
+            if( nodeMask( node, mask ) )
+                syscall( SYS_set_mempolicy, MemoryPolicyPreferred, &mask, sizeof(mask) * 8 + 1 );
+        #endif
+        task( data );
+    } );
+    thread.join();
+}
+
+void* allocateOnNumaNode( std::size_t node, std::size_t size )
+{
+    #if defined(__linux__)
+        void* memory= mmap( nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+        if( memory == MAP_FAILED )
+            return nullptr;
+
+        // the pages are not touched yet, hence the policy decides where they are placed
+        unsigned long mask;
+        if( numaNodeCount() > 1 && nodeMask( node, mask ) )
+            syscall( SYS_mbind, memory, size, MemoryPolicyPreferred, &mask, sizeof(mask) * 8 + 1, 0 );
+        return memory;
+    #else
+        (void) node;
+        return std::malloc( size );
+    #endif
+}
+
+void  freeOnNumaNode( void* memory, std::size_t size )
+{
+    #if defined(__linux__)
+        munmap( memory, size );
+    #else
+        (void) size;
+        std::free( memory );
+    #endif
+}
+
+//! @endcond
+
+}}} // namespace [aworx::lib::singletons]
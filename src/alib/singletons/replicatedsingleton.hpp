@@ -0,0 +1,376 @@
+// #################################################################################################
+//  ALib C++ Library
+//
+//  Module Singletons
+//
+//  Copyright 2013-2019 A-Worx GmbH, Germany
+//  Published under 'Boost Software License' (a free software license, see LICENSE.txt)
+// #################################################################################################
+#ifndef HPP_ALIB_SINGLETONS_REPLICATEDSINGLETON
+#define HPP_ALIB_SINGLETONS_REPLICATEDSINGLETON 1
+
+#if !defined (HPP_ALIB_SINGLETONS_SINGLETON)
+#   include "alib/singletons/singleton.hpp"
+#endif
+
+#if !defined (_GLIBCXX_MUTEX) && !defined(_MUTEX_)
+#   include <mutex>
+#endif
+
+#if !defined (_GLIBCXX_CSTDLIB) && !defined(_CSTDLIB_)
+#   include <cstdlib>
+#endif
+
+#if !defined (_GLIBCXX_CSTDINT) && !defined(_CSTDINT_)
+#   include <cstdint>
+#endif
+
+#if !defined (_ASSERT_H) && !defined(assert)
+#   include <assert.h>
+#endif
+
+namespace aworx { namespace lib { namespace singletons {
+
+//! @cond NO_DOX
+/**
+ * Returns the number of NUMA nodes that have CPUs. The topology is read once from
+ * <c>/sys/devices/system/node</c> on GNU/Linux. If it is not available, \c 1 is returned.
+ * @return The number of nodes.
+ */
+extern ALIB_API std::size_t  numaNodeCount();
+
+/**
+ * Returns the index of the NUMA node of the CPU that the current thread runs on.
+ * @return The node index, less than #numaNodeCount.
+ */
+extern ALIB_API std::size_t  currentNumaNode();
+
+/**
+ * Runs \p{task} on a thread that is bound to the CPUs of the given NUMA node and prefers the
+ * node's memory, and waits for its completion. With a single node, \p{task} is invoked by the
+ * calling thread.
+ * @param node  The index of the node.
+ * @param task  The task.
+ * @param data  The argument passed to \p{task}.
+ */
+extern ALIB_API void         runOnNumaNode( std::size_t node, void (*task)( void* ), void* data );
+
+/**
+ * Allocates memory that is placed on the given NUMA node. On GNU/Linux, whole pages are mapped
+ * and bound to the node before they are touched. Elsewhere, the heap is used.
+ * @param node  The index of the node.
+ * @param size  The size of the memory.
+ * @return The memory, \c nullptr if out of memory.
+ */
+extern ALIB_API void*        allocateOnNumaNode( std::size_t node, std::size_t size );
+
+/**
+ * Frees memory allocated with #allocateOnNumaNode.
+ * @param memory The memory.
+ * @param size   The size passed to #allocateOnNumaNode.
+ */
+extern ALIB_API void         freeOnNumaNode( void* memory, std::size_t size );
+//! @endcond
+
+/** ************************************************************************************************
+ * A variant of class \alib{singletons,Singleton}, which provides one instance (replica) of
+ * \p{TDerivedClass} per NUMA node. This is useful for large read-mostly objects, like lookup
+ * tables or compiled rule sets, which otherwise reside in the memory of the node that
+ * constructed them, so that threads on other nodes access remote memory with each read.
+ * #GetReplica returns the replica of the node that the current thread runs on.
+ *
+ * The topology is read from <c>/sys/devices/system/node</c> on GNU/Linux. Nodes without CPUs
+ * are ignored. On other platforms, or if the topology is not available, a single replica is
+ * created, which is then accessed without detecting the node.
+ *
+ * On GNU/Linux, the memory of each replica is mapped with \c mmap in whole pages, which are
+ * bound to the node with \c mbind (policy \c MPOL_PREFERRED) before they are touched. The kernel
+ * hence places them on the node when the replica is constructed. The replica is constructed by
+ * a thread that is bound to the CPUs of its node and whose memory policy (\c set_mempolicy)
+ * prefers the node. Memory that the constructor of \p{TDerivedClass} allocates is placed on
+ * the node as well, unless the heap returns memory of pages that were touched before.
+ *
+ * If \p{TDerivedClass} is copy constructible, the first replica is default constructed and the
+ * others are copies of it. Otherwise, each replica is default constructed. Constructors must
+ * not throw.
+ *
+ * Replicas should not be modified in place. Instead, #Update creates a new set of replicas from
+ * a modified copy and replaces the current set with \alib{singletons,Singleton::Replace}. Threads
+ * that might use a replica while it is updated have to do this within the scope of a
+ * \alib{singletons,SingletonReadGuard}.
+ *
+ * The replicas are created together with the first invocation of #GetReplica, #ForEachReplica
+ * or #Update. They are held by a \alib{singletons,Singleton}. Hence, with mapped mode, they are
+ * shared among all code entities (executable and shared libraries) of a process, and they are
+ * deleted with \alib{singletons,DeleteSingletons}.
+ *
+ * @tparam TDerivedClass Template parameter that denotes the name of the class that implements
+ *                       the replicas.
+ **************************************************************************************************/
+template <typename TDerivedClass>
+class ReplicatedSingleton
+{
+    protected:
+        /** The size of a cache line. */
+        static constexpr std::size_t CacheLineSize= 64;
+
+        /** The replicas. */
+        class Replicas : public Singleton<Replicas>
+        {
+            public:
+                /** The number of replicas, which equals the number of NUMA nodes. */
+                std::size_t         count;
+
+                /** The memory allocated for each replica. */
+                void**              memory;
+
+                /** The replica of each node. */
+                TDerivedClass**     replicas;
+
+                /** Constructor. Creates the replicas. */
+                Replicas()
+                {
+                    create( nullptr, []( TDerivedClass& ) {} );
+                }
+
+                /**
+                 * Constructor. Creates the replicas from a modified copy of \p{source}.
+                 * @param source The replica to copy.
+                 * @param modify A callable that accepts a reference to \p{TDerivedClass}.
+                 * @tparam TModify The type of \p{modify}.
+                 */
+                template<typename TModify>
+                Replicas( const TDerivedClass& source, TModify& modify )
+                {
+                    create( &source, modify );
+                }
+
+                /** Destructor. Deletes the replicas. */
+                virtual ~Replicas()
+                {
+                    for( std::size_t node= 0 ; node < count ; ++node )
+                    {
+                        replicas[node]->~TDerivedClass();
+                        freeOnNumaNode( memory[node], allocationSize() );
+                    }
+                    delete[] replicas;
+                    delete[] memory;
+                }
+
+                /**
+                 * Returns a replica.
+                 * @param node The index of the node.
+                 * @return The replica.
+                 */
+                TDerivedClass& Get( std::size_t node )
+                {
+                    return *replicas[node];
+                }
+
+            protected:
+                /**
+                 * The creation of a replica on its node.
+                 * @tparam TModify The type of the modification.
+                 */
+                template<typename TModify>
+                struct Creation
+                {
+                    Replicas*               self;   ///< The replicas.
+                    std::size_t             node;   ///< The node of the replica.
+                    const TDerivedClass*    source; ///< \c nullptr or the object to copy.
+                    TModify*                modify; ///< Applied to the replica of the first node.
+
+                    /**
+                     * Creates the replica.
+                     * @param data The creation.
+                     */
+                    static void run( void* data )
+                    {
+                        Creation* creation= static_cast<Creation*>( data );
+                        void*     place   = creation->self->allocate( creation->node );
+                        TDerivedClass* replica= copyOrBuild( place, creation->source,
+                                                             std::is_copy_constructible<TDerivedClass>() );
+                        if( creation->node == 0 )
+                            (*creation->modify)( *replica );
+                        creation->self->replicas[creation->node]= replica;
+                    }
+                };
+
+                /**
+                 * Creates the replicas, one after the other.
+                 * @param source \c nullptr or the object that the first replica copies.
+                 * @param modify Applied to the first replica.
+                 * @tparam TModify The type of \p{modify}.
+                 */
+                template<typename TModify>
+                void create( const TDerivedClass* source, TModify&& modify )
+                {
+                    count   = numaNodeCount();
+                    memory  = new void*[count];
+                    replicas= new TDerivedClass*[count];
+
+                    using TStored= typename std::remove_reference<TModify>::type;
+                    for( std::size_t node= 0 ; node < count ; ++node )
+                    {
+                        Creation<TStored> creation= { this, node, node == 0 ? source : replicas[0],
+                                                      &modify };
+                        runOnNumaNode( node, &Creation<TStored>::run, &creation );
+                    }
+                }
+
+                /**
+                 * Returns the alignment of a replica, which is at least a cache line.
+                 * @return The alignment.
+                 */
+                static constexpr std::size_t alignment()
+                {
+                    return alignof(TDerivedClass) > CacheLineSize ? alignof(TDerivedClass)
+                                                                  : CacheLineSize;
+                }
+
+                /**
+                 * Returns the size of the memory allocated for a replica.
+                 * @return The size padded to whole cache lines, plus the alignment.
+                 */
+                static constexpr std::size_t allocationSize()
+                {
+                    return ( sizeof(TDerivedClass) + alignment() - 1 ) / alignment() * alignment()
+                           + alignment();
+                }
+
+                /**
+                 * Allocates the memory of a replica on its node, aligned to and padded to whole
+                 * cache lines.
+                 * @param node The index of the node.
+                 * @return The aligned memory.
+                 */
+                void* allocate( std::size_t node )
+                {
+                    memory[node]= allocateOnNumaNode( node, allocationSize() );
+                    if( memory[node] == nullptr )
+                    {
+                        assert( false ); // Out of memory
+                        std::abort();
+                    }
+
+                    std::uintptr_t address= reinterpret_cast<std::uintptr_t>( memory[node] );
+                    return static_cast<char*>( memory[node] ) + ( alignment() - address % alignment() ) % alignment();
+                }
+
+                /**
+                 * Copy constructs a replica, or default constructs it, if \p{source} is
+                 * \c nullptr.
+                 * @param place  The memory of the replica.
+                 * @param source \c nullptr or the object to copy.
+                 * @return The replica.
+                 */
+                static TDerivedClass* copyOrBuild( void* place, const TDerivedClass* source,
+                                                   std::true_type )
+                {
+                    if( source != nullptr )
+                        return new ( place ) TDerivedClass( *source );
+                    return new ( place ) TDerivedClass();
+                }
+
+                /**
+                 * Default constructs a replica of a type that is not copy constructible.
+                 * @param place  The memory of the replica.
+                 * @return The replica.
+                 */
+                static TDerivedClass* copyOrBuild( void* place, const TDerivedClass*, std::false_type )
+                {
+                    return new ( place ) TDerivedClass();
+                }
+        };
+
+        /** Serializes #Update. A singleton, to be shared among code entities with mapped mode. */
+        class UpdateLock : public Singleton<UpdateLock>
+        {
+            public:
+                std::mutex          mutex;  ///< The mutex.
+        };
+
+    public:
+        /**
+         * Returns the replica of the NUMA node that the current thread runs on.
+         * Because threads might be moved to other nodes at any time, the replica might be the
+         * one of another node, which is correct, but slower.
+         * @return The replica of the current thread.
+         */
+        inline static TDerivedClass&    GetReplica()
+        {
+            Replicas& replicas= Replicas::GetSingleton();
+            if( replicas.count == 1 )
+                return replicas.Get( 0 );
+            return replicas.Get( currentNumaNode() );
+        }
+
+        /**
+         * Returns the replica with the given index.
+         * @param node The index of the NUMA node. Has to be less than #ReplicaCount.
+         * @return The replica.
+         */
+        static TDerivedClass&           GetReplica( std::size_t node )
+        {
+            return Replicas::GetSingleton().Get( node );
+        }
+
+        /**
+         * Returns the number of replicas, which equals the number of NUMA nodes.
+         * @return The number of replicas.
+         */
+        static std::size_t              ReplicaCount()
+        {
+            return Replicas::GetSingleton().count;
+        }
+
+        /**
+         * Invokes \p{callable} with each replica.
+         * @param callable A callable that accepts a reference to \p{TDerivedClass}.
+         * @tparam TCallable The type of \p{callable}.
+         */
+        template<typename TCallable>
+        static void                     ForEachReplica( TCallable&& callable )
+        {
+            Replicas& replicas= Replicas::GetSingleton();
+            for( std::size_t node= 0 ; node < replicas.count ; ++node )
+                callable( replicas.Get( node ) );
+        }
+
+        /**
+         * Modifies the replicas: a copy of the first replica is modified with \p{modify} and
+         * then copied to the other nodes. The new replicas replace the current ones with
+         * \alib{singletons,Singleton::Replace}, hence each thread receives either the old or the
+         * new replica, and the old replicas are deleted once no
+         * \alib{singletons,SingletonReadGuard} that existed at the time of the update is left.
+         *
+         * Updates are serialized. \p{TDerivedClass} has to be copy constructible.
+         *
+         * @param modify A callable that accepts a reference to \p{TDerivedClass}. It is invoked
+         *               once, on a thread of the first node.
+         * @tparam TModify The type of \p{modify}.
+         */
+        template<typename TModify>
+        static void                     Update( TModify&& modify )
+        {
+            static_assert( std::is_copy_constructible<TDerivedClass>::value,
+                           "ReplicatedSingleton::Update needs a copy constructible type" );
+
+            std::lock_guard<std::mutex> guard( UpdateLock::GetSingleton().mutex );
+            Replicas& current= Replicas::GetSingleton();
+            Replicas::Replace( std::unique_ptr<Replicas>( new Replicas( current.Get( 0 ), modify ) ) );
+        }
+};// class ReplicatedSingleton
+
+template <typename TDerivedClass>
+constexpr std::size_t          ReplicatedSingleton<TDerivedClass>::CacheLineSize;
+
+}} // namespace aworx[::lib::singletons]
+
+/// Type alias in namespace #aworx.
+template<typename T>
+using ReplicatedSingleton=    aworx::lib::singletons::ReplicatedSingleton<T>;
+
+} // namespace aworx
+
+#endif // HPP_ALIB_SINGLETONS_REPLICATEDSINGLETON
@@ -0,0 +1,67 @@
+// #################################################################################################
+//  ALib C++ Library
+//
+//  Copyright 2013-2019 A-Worx GmbH, Germany
+//  Published under 'Boost Software License' (a free software license, see LICENSE.txt)
+// #################################################################################################
+#include "alib/singletons/shardedsingleton.hpp"
+
+#if defined(__linux__)
+#   include <cstdio>
+#   include <cstring>
+#   include <unistd.h>
+#endif
+
+namespace aworx { namespace lib { namespace singletons {
+
+//! @cond NO_DOX
+
+namespace {
+
+/**
+ * Detects the number of CPU identifiers.
+ * @return The highest possible CPU identifier plus one.
+ */
+std::size_t detectCpuIdCount()
+{
+    #if defined(__linux__)
+        // a list like "0-7" or "0,2-5". The highest identifier is the last number.
+        std::FILE* file= std::fopen( "/sys/devices/system/cpu/possible", "r" );
+        if( file != nullptr )
+        {
+            char buffer[256];
+            bool success= std::fgets( buffer, sizeof(buffer), file ) != nullptr;
+            std::fclose( file );
+            if( success )
+            {
+                const char* last= buffer;
+                for( const char* c= buffer ; *c != '\0' ; ++c )
+                    if( *c == ',' || *c == '-' )
+                        last= c + 1;
+                char* end;
+                long  highest= std::strtol( last, &end, 10 );
+                if( end != last && highest >= 0 )
+                    return static_cast<std::size_t>( highest ) + 1;
+            }
+        }
+
+        long configured= sysconf( _SC_NPROCESSORS_CONF );
+        if( configured > 0 )
+            return static_cast<std::size_t>( configured );
+    #endif
+
+    unsigned int hardwareThreads= std::thread::hardware_concurrency();
+    return hardwareThreads > 0 ? hardwareThreads : 1;
+}
+
+} // anonymous namespace
+
+std::size_t  cpuIdCount()
+{
+    static const std::size_t count= detectCpuIdCount();
+    return count;
+}
+
+//! @endcond
+
+}}} // namespace [aworx::lib::singletons]
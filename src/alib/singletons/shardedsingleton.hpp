@@ -0,0 +1,250 @@
+// #################################################################################################
+//  ALib C++ Library
+//
+//  Module Singletons
+//
+//  Copyright 2013-2019 A-Worx GmbH, Germany
+//  Published under 'Boost Software License' (a free software license, see LICENSE.txt)
+// #################################################################################################
+#ifndef HPP_ALIB_SINGLETONS_SHARDEDSINGLETON
+#define HPP_ALIB_SINGLETONS_SHARDEDSINGLETON 1
+
+#if !defined (HPP_ALIB_SINGLETONS_SINGLETON)
+#   include "alib/singletons/singleton.hpp"
+#endif
+
+#if !defined (_GLIBCXX_THREAD) && !defined(_THREAD_)
+#   include <thread>
+#endif
+
+#if !defined (_GLIBCXX_CSTDLIB) && !defined(_CSTDLIB_)
+#   include <cstdlib>
+#endif
+
+#if !defined (_GLIBCXX_CSTDINT) && !defined(_CSTDINT_)
+#   include <cstdint>
+#endif
+
+#if !defined (_ASSERT_H) && !defined(assert)
+#   include <assert.h>
+#endif
+
+#if defined(__linux__)
+#   include <sched.h>
+#endif
+
+namespace aworx { namespace lib { namespace singletons {
+
+//! @cond NO_DOX
+/**
+ * Returns the number of CPU identifiers, which is the highest possible identifier plus one, as
+ * read once from <c>/sys/devices/system/cpu/possible</c> on GNU/Linux. Identifiers of offline
+ * or hot-pluggable CPUs are included, as well as gaps between identifiers. Falls back to the
+ * number of configured CPUs and to the number of hardware threads.
+ * @return The number of CPU identifiers.
+ */
+extern ALIB_API std::size_t  cpuIdCount();
+//! @endcond
+
+/** ************************************************************************************************
+ * A variant of class \alib{singletons,Singleton}, which provides a fixed number of instances
+ * (shards) of \p{TDerivedClass}, one per CPU. Each shard is aligned to and padded to whole
+ * cache lines. This is useful for global state that is modified frequently by many threads,
+ * like counters, free-lists or rate limiters: each thread modifies the shard of the CPU it
+ * runs on, which avoids transferring cache lines between CPUs. Readers combine the shards with
+ * #ForEachShard or #Reduce.
+ *
+ * The shard of a thread is selected with \c sched_getcpu on GNU/Linux. On other platforms, or if
+ * \c sched_getcpu fails, a hash of the thread's identifier is used.
+ * Because threads might be moved to other CPUs at any time, different threads might access the
+ * same shard concurrently. Hence, fields of \p{TDerivedClass} still have to be atomic (usually
+ * with relaxed memory order) or otherwise synchronized.
+ *
+ * The shards are created together with the first invocation of #GetShard, #ForEachShard or
+ * #Reduce. On GNU/Linux, the number of shards equals the highest possible CPU identifier plus
+ * one, hence each CPU has its own shard, even if identifiers are sparse or CPUs are brought
+ * online later. Elsewhere, it equals the number of hardware threads.
+ * The shards are held by a \alib{singletons,Singleton}. Hence, with mapped mode, they are shared
+ * among all code entities (executable and shared libraries) of a process, and they are deleted
+ * with \alib{singletons,DeleteSingletons}.
+ *
+ * @tparam TDerivedClass Template parameter that denotes the name of the class that implements
+ *                       the shards.
+ **************************************************************************************************/
+template <typename TDerivedClass>
+class ShardedSingleton
+{
+    protected:
+        /** The size of a cache line. */
+        static constexpr std::size_t CacheLineSize= 64;
+
+        /** The shards. */
+        class Shards : public Singleton<Shards>
+        {
+            public:
+                /** The number of shards. */
+                std::size_t         count;
+
+                /** The distance of two shards, in bytes. A multiple of the cache line size. */
+                std::size_t         stride;
+
+                /** The memory allocated. */
+                void*               memory;
+
+                /** The first shard. Aligned to a cache line. */
+                char*               first;
+
+                /**
+                 * Constructor. Creates the shards. If a constructor of \p{TDerivedClass}
+                 * throws, the shards created before are destructed and the memory is freed.
+                 */
+                Shards()
+                {
+                    std::size_t alignment= alignof(TDerivedClass) > CacheLineSize ? alignof(TDerivedClass)
+                                                                                  : CacheLineSize;
+                    count = cpuIdCount();
+                    stride= ( sizeof(TDerivedClass) + alignment - 1 ) / alignment * alignment;
+                    memory= std::malloc( count * stride + alignment );
+                    if( memory == nullptr )
+                    {
+                        assert( false ); // Out of memory
+                        std::abort();
+                    }
+
+                    std::uintptr_t address= reinterpret_cast<std::uintptr_t>( memory );
+                    first= static_cast<char*>( memory ) + ( alignment - address % alignment ) % alignment;
+                    std::size_t constructed= 0;
+                    try
+                    {
+                        for( ; constructed < count ; ++constructed )
+                            new ( first + constructed * stride ) TDerivedClass();
+                    }
+                    catch( ... )
+                    {
+                        while( constructed > 0 )
+                            Get( --constructed ).~TDerivedClass();
+                        std::free( memory );
+                        throw;
+                    }
+                }
+
+                /** Destructor. Deletes the shards. */
+                virtual ~Shards()
+                {
+                    for( std::size_t idx= 0 ; idx < count ; ++idx )
+                        Get( idx ).~TDerivedClass();
+                    std::free( memory );
+                }
+
+                /**
+                 * Returns a shard.
+                 * @param idx The index of the shard.
+                 * @return The shard.
+                 */
+                TDerivedClass& Get( std::size_t idx )
+                {
+                    return *reinterpret_cast<TDerivedClass*>( first + idx * stride );
+                }
+        };
+
+        /** The hash of the current thread, used if the current CPU is not available. */
+        static thread_local std::size_t     threadHash;
+
+        /**
+         * Returns the index of the shard of the current thread.
+         * @param count The number of shards.
+         * @return The index of the shard.
+         */
+        static std::size_t                  shardIndex( std::size_t count )
+        {
+            #if defined(__linux__)
+                int cpu= sched_getcpu();
+                if( cpu >= 0 )
+                    return static_cast<std::size_t>( cpu ) % count;
+            #endif
+
+            std::size_t hash= threadHash;
+            if( hash == 0 )
+                // a multiplicative mix, as thread identifiers are often aligned addresses
+                hash= threadHash= ( std::hash<std::thread::id>()( std::this_thread::get_id() )
+                                    * static_cast<std::size_t>( 0x9E3779B97F4A7C15ull ) ) | 1;
+            return ( hash >> ( sizeof(std::size_t) * 4 ) ) % count;
+        }
+
+    public:
+        /**
+         * Returns the shard of the CPU that the current thread runs on.
+         * @return The shard of the current thread.
+         */
+        inline static TDerivedClass&    GetShard()
+        {
+            Shards& shards= Shards::GetSingleton();
+            return shards.Get( shardIndex( shards.count ) );
+        }
+
+        /**
+         * Returns the shard with the given index.
+         * @param idx The index of the shard. Has to be less than #ShardCount.
+         * @return The shard.
+         */
+        static TDerivedClass&           GetShard( std::size_t idx )
+        {
+            return Shards::GetSingleton().Get( idx );
+        }
+
+        /**
+         * Returns the number of shards.
+         * @return The number of shards.
+         */
+        static std::size_t              ShardCount()
+        {
+            return Shards::GetSingleton().count;
+        }
+
+        /**
+         * Invokes \p{callable} with each shard.
+         * @param callable A callable that accepts a reference to \p{TDerivedClass}.
+         * @tparam TCallable The type of \p{callable}.
+         */
+        template<typename TCallable>
+        static void                     ForEachShard( TCallable&& callable )
+        {
+            Shards& shards= Shards::GetSingleton();
+            for( std::size_t idx= 0 ; idx < shards.count ; ++idx )
+                callable( shards.Get( idx ) );
+        }
+
+        /**
+         * Combines the shards into one value.
+         * @param value    The initial value.
+         * @param combine  A callable that accepts \p{value} and a reference to
+         *                 \p{TDerivedClass} and returns the combined value.
+         * @tparam TValue   The type of \p{value}.
+         * @tparam TCombine The type of \p{combine}.
+         * @return The combined value.
+         */
+        template<typename TValue, typename TCombine>
+        static TValue                   Reduce( TValue value, TCombine&& combine )
+        {
+            Shards& shards= Shards::GetSingleton();
+            for( std::size_t idx= 0 ; idx < shards.count ; ++idx )
+                value= combine( value, shards.Get( idx ) );
+            return value;
+        }
+};// class ShardedSingleton
+
+template <typename TDerivedClass>
+constexpr std::size_t          ShardedSingleton<TDerivedClass>::CacheLineSize;
+
+template <typename TDerivedClass>
+thread_local std::size_t       ShardedSingleton<TDerivedClass>::threadHash= 0;
+
+}} // namespace aworx[::lib::singletons]
+
+/// Type alias in namespace #aworx.
+template<typename T>
+using ShardedSingleton=    aworx::lib::singletons::ShardedSingleton<T>;
+
+} // namespace aworx
+
+#endif // HPP_ALIB_SINGLETONS_SHARDEDSINGLETON
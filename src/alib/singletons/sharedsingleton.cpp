@@ -0,0 +1,175 @@
+// #################################################################################################
+//  ALib C++ Library
+//
+//  Copyright 2013-2019 A-Worx GmbH, Germany
+//  Published under 'Boost Software License' (a free software license, see LICENSE.txt)
+// #################################################################################################
+#include "alib/singletons/sharedsingleton.hpp"
+
+#if !defined (_GLIBCXX_ATOMIC) && !defined(_ATOMIC_)
+#   include <atomic>
+#endif
+
+#if !defined (_ASSERT_H) && !defined(assert)
+#   include <assert.h>
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#   define ALIB_SHARED_MEMORY 1
+#   include <fcntl.h>
+#   include <sys/file.h>
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <unistd.h>
+#else
+#   define ALIB_SHARED_MEMORY 0
+#endif
+
+namespace aworx { namespace lib { namespace singletons {
+
+//! @cond NO_DOX
+
+#if ALIB_SHARED_MEMORY
+
+namespace {
+
+/** Identifies segments of shared singletons. */
+constexpr std::uint64_t SegmentMagic= 0x316D685362694C41ull; // "ALibShm1"
+
+/** The header of a segment, followed by the object. */
+struct SegmentHeader
+{
+    std::uint64_t               magic;      ///< Set to #SegmentMagic.
+    std::uint64_t               hash;       ///< Identifies type and layout of the object.
+    std::uint64_t               size;       ///< The size of the object.
+    std::uint32_t               version;    ///< The version of the object.
+    std::atomic<std::uint32_t>  ready;      ///< Set to \c 1 when the object was constructed.
+};
+
+/**
+ * Returns the offset of the object in a segment.
+ * @param alignment The alignment of the object.
+ * @return The size of the header, padded to the alignment.
+ */
+std::size_t objectOffset( std::size_t alignment )
+{
+    std::size_t offset= sizeof(SegmentHeader) < 64 ? 64 : sizeof(SegmentHeader);
+    return ( offset + alignment - 1 ) / alignment * alignment;
+}
+
+/**
+ * Tests if the segment holds a constructed object of the given type, layout and version.
+ * @param fd        The segment's file descriptor. A lock on it has to be held.
+ * @param length    The size of the segment.
+ * @param hash      Identifies type and layout of the object.
+ * @param version   The version of the object.
+ * @return \c 1 if ready, \c 0 if not constructed, \c -1 if constructed with a different
+ *         type, layout or version.
+ */
+int isReady( int fd, std::size_t length, std::uint64_t hash, std::uint32_t version )
+{
+    struct stat status;
+    if( fstat( fd, &status ) != 0 || static_cast<std::size_t>( status.st_size ) < length )
+        return 0;
+
+    void* mapped= mmap( nullptr, sizeof(SegmentHeader), PROT_READ, MAP_SHARED, fd, 0 );
+    if( mapped == MAP_FAILED )
+        return 0;
+
+    const SegmentHeader* header= static_cast<const SegmentHeader*>( mapped );
+    int result= 0;
+    if( header->ready.load( std::memory_order_acquire ) == 1 )
+        result=    header->magic   == SegmentMagic
+                && header->hash    == hash
+                && header->version == version ? 1 : -1;
+    munmap( mapped, sizeof(SegmentHeader) );
+    return result;
+}
+
+} // anonymous namespace
+
+const void*  attachSharedSegment( const char* name, std::size_t size, std::size_t alignment,
+                                  std::uint64_t hash, std::uint32_t version,
+                                  void (*construct)( void* ) )
+{
+    std::size_t offset= objectOffset( alignment );
+    std::size_t length= offset + size;
+
+    int fd= shm_open( name, O_RDWR | O_CREAT, 0600 );
+    if( fd < 0 )
+        return nullptr;
+
+    // readers share the lock, the constructing process holds it exclusively. If that process
+    // dies, the lock is released and the next process constructs the object.
+    int ready= 0;
+    if( flock( fd, LOCK_SH ) == 0 )
+    {
+        ready= isReady( fd, length, hash, version );
+        if( ready == 0 && flock( fd, LOCK_EX ) == 0 )
+        {
+            // another process might have constructed the object in between
+            ready= isReady( fd, length, hash, version );
+            if( ready == 0 && ftruncate( fd, static_cast<off_t>( length ) ) == 0 )
+            {
+                void* mapped= mmap( nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+                if( mapped != MAP_FAILED )
+                {
+                    SegmentHeader* header= static_cast<SegmentHeader*>( mapped );
+                    header->ready.store( 0, std::memory_order_relaxed );
+                    construct( static_cast<char*>( mapped ) + offset );
+                    header->magic  = SegmentMagic;
+                    header->hash   = hash;
+                    header->size   = size;
+                    header->version= version;
+                    header->ready.store( 1, std::memory_order_release );
+                    munmap( mapped, length );
+                    ready= 1;
+                }
+            }
+        }
+    }
+
+    const void* result= nullptr;
+    if( ready == 1 )
+    {
+        void* mapped= mmap( nullptr, length, PROT_READ, MAP_SHARED, fd, 0 );
+        if( mapped != MAP_FAILED )
+            result= static_cast<const char*>( mapped ) + offset;
+    }
+    assert( ready != -1 ); // Segment exists with a different type, layout or version
+
+    flock( fd, LOCK_UN );
+    close( fd );
+    return result;
+}
+
+void  detachSharedSegment( const void* object, std::size_t size, std::size_t alignment )
+{
+    std::size_t offset= objectOffset( alignment );
+    munmap( const_cast<char*>( static_cast<const char*>( object ) - offset ), offset + size );
+}
+
+void  unlinkSharedSegment( const char* name )
+{
+    shm_unlink( name );
+}
+
+#else
+
+const void*  attachSharedSegment( const char*, std::size_t, std::size_t, std::uint64_t,
+                                  std::uint32_t, void (*)( void* ) )
+{
+    return nullptr;
+}
+
+void  detachSharedSegment( const void*, std::size_t, std::size_t )
+{}
+
+void  unlinkSharedSegment( const char* )
+{}
+
+#endif // ALIB_SHARED_MEMORY
+
+//! @endcond
+
+}}} // namespace [aworx::lib::singletons]
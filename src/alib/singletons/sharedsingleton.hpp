@@ -0,0 +1,225 @@
+// #################################################################################################
+//  ALib C++ Library
+//
+//  Module Singletons
+//
+//  Copyright 2013-2019 A-Worx GmbH, Germany
+//  Published under 'Boost Software License' (a free software license, see LICENSE.txt)
+// #################################################################################################
+#ifndef HPP_ALIB_SINGLETONS_SHAREDSINGLETON
+#define HPP_ALIB_SINGLETONS_SHAREDSINGLETON 1
+
+#if !defined (HPP_ALIB_SINGLETONS_SINGLETON)
+#   include "alib/singletons/singleton.hpp"
+#endif
+
+#if !defined (_GLIBCXX_CSTDINT) && !defined(_CSTDINT_)
+#   include <cstdint>
+#endif
+
+#if !defined (_GLIBCXX_TYPE_TRAITS) && !defined(_TYPE_TRAITS_)
+#   include <type_traits>
+#endif
+
+#if !defined(HPP_ALIB_LIB_TYPEKEY)
+#   include "alib/lib/typekey.hpp"
+#endif
+
+namespace aworx { namespace lib { namespace singletons {
+
+//! @cond NO_DOX
+/**
+ * Attaches to the shared memory segment \p{name}, which is created and initialized with
+ * \p{construct}, if it does not exist or was not completely initialized.
+ * @param name       The name of the segment.
+ * @param size       The size of the object.
+ * @param alignment  The alignment of the object.
+ * @param hash       Identifies type and layout of the object.
+ * @param version    The version of the object.
+ * @param construct  Constructs the object at the given address.
+ * @return The object, mapped read-only. \c nullptr if shared memory is not available.
+ */
+extern ALIB_API const void*  attachSharedSegment( const char* name, std::size_t size,
+                                                  std::size_t alignment, std::uint64_t hash,
+                                                  std::uint32_t version,
+                                                  void (*construct)( void* ) );
+
+/**
+ * Detaches a segment received with #attachSharedSegment.
+ * @param object     The object received.
+ * @param size       The size of the object.
+ * @param alignment  The alignment of the object.
+ */
+extern ALIB_API void         detachSharedSegment( const void* object, std::size_t size,
+                                                  std::size_t alignment );
+
+/**
+ * Removes the name of a shared memory segment.
+ * @param name The name of the segment.
+ */
+extern ALIB_API void         unlinkSharedSegment( const char* name );
+//! @endcond
+
+/** ************************************************************************************************
+ * A variant of class \alib{singletons,Singleton}, whose instance is shared read-only by all
+ * processes of a host. This is useful for large, immutable data like lookup tables, which
+ * otherwise would be built by each of a set of worker processes.
+ *
+ * The first process that requests the singleton creates a named POSIX shared memory segment
+ * (\c shm_open) and constructs the instance therein. Other processes attach to the segment
+ * with \c mmap and use the instance without copying it. Constructions are serialized with a
+ * file lock on the segment: processes that request the singleton while it is constructed wait
+ * until the construction completed. If the constructing process dies, the lock is released by
+ * the operating system and the next process constructs the instance again.
+ *
+ * The name of the segment is derived from the name, the size and the alignment of
+ * \p{TDerivedClass} and from \p{TVersion}. Hence, processes that use different layouts of the
+ * type use different segments. \p{TVersion} has to be changed whenever the data constructed
+ * changes without a change of the layout. Segments persist until the host is rebooted or until
+ * their name is removed with #Unlink.
+ *
+ * \p{TDerivedClass} has to be trivially copyable and must not contain pointers, because the
+ * segment is mapped to different addresses in different processes. References between parts
+ * of the instance have to be given as offsets. The instance is constructed with the default
+ * constructor and is never destructed. After construction, memory is mapped read-only in all
+ * processes, including the constructing one.
+ *
+ * On platforms without POSIX shared memory, or if a segment can not be created, the instance is
+ * constructed in the heap of each process.
+ * The instance of a process is held by a \alib{singletons,Singleton}. Hence, with mapped mode,
+ * it is shared among all code entities (executable and shared libraries) of a process, and it
+ * is detached with \alib{singletons,DeleteSingletons}.
+ *
+ * With older versions of the GNU C library, programs have to be linked with library \c rt.
+ *
+ * @tparam TDerivedClass Template parameter that denotes the name of the class that implements
+ *                       the shared singleton.
+ * @tparam TVersion      The version of the data constructed. Defaults to \c 0.
+ **************************************************************************************************/
+template <typename TDerivedClass, std::uint32_t TVersion= 0>
+class SharedSingleton
+{
+    protected:
+        /** The instance, attached to the shared memory segment or created in the heap. */
+        class Segment : public Singleton<Segment>
+        {
+            public:
+                /** The instance. */
+                const TDerivedClass*    instance;
+
+                /** Denotes if #instance is located in shared memory. */
+                bool                    shared;
+
+                /** Constructor. Attaches to the segment or creates the instance. */
+                Segment()
+                {
+                    const void* object= attachSharedSegment( Name().name, sizeof(TDerivedClass),
+                                                             alignof(TDerivedClass), Hash(),
+                                                             TVersion, &construct );
+                    shared  = object != nullptr;
+                    instance= shared ? static_cast<const TDerivedClass*>( object )
+                                     : new TDerivedClass();
+                }
+
+                /** Destructor. Detaches from the segment or deletes the instance. */
+                virtual ~Segment()
+                {
+                    if( shared )
+                        detachSharedSegment( instance, sizeof(TDerivedClass),
+                                             alignof(TDerivedClass) );
+                    else
+                        delete instance;
+                }
+        };
+
+        /** The name of a segment. */
+        struct SegmentName
+        {
+            char    name[32];   ///< The zero-terminated name.
+        };
+
+        /**
+         * Identifies the type and its layout.
+         * @return The hash code of the type name, its size and its alignment.
+         */
+        static std::uint64_t            Hash()
+        {
+            std::uint64_t hash= static_cast<std::uint64_t>( TypeKey::Of<TDerivedClass>().Hash() );
+            hash= ( hash ^ sizeof (TDerivedClass) ) * 1099511628211ull;
+            hash= ( hash ^ alignof(TDerivedClass) ) * 1099511628211ull;
+            return hash;
+        }
+
+        /**
+         * Returns the name of the segment.
+         * @return The name of the segment.
+         */
+        static SegmentName              Name()
+        {
+            SegmentName   result;
+            std::uint64_t hash= Hash();
+            char*         it  = result.name;
+            for( const char* prefix= "/alib-" ; *prefix ; ++prefix )
+                *it++= *prefix;
+            for( int shift= 60 ; shift >= 0 ; shift-= 4 )
+                *it++= "0123456789abcdef"[( hash >> shift ) & 0xF];
+            *it++= '-';
+            for( int shift= 28 ; shift >= 0 ; shift-= 4 )
+                *it++= "0123456789abcdef"[( TVersion >> shift ) & 0xF];
+            *it= '\0';
+            return result;
+        }
+
+        /**
+         * Constructs the instance in the segment.
+         * @param memory The memory of the instance.
+         */
+        static void                     construct( void* memory )
+        {
+            #if !defined(__GNUC__) || __GNUC__ >= 5 || defined(__clang__)
+                static_assert( std::is_trivially_copyable<TDerivedClass>::value,
+                               "Shared singletons have to be trivially copyable" );
+            #endif
+            new ( memory ) TDerivedClass();
+        }
+
+    public:
+        /**
+         * Attaches to (or, if not done, yet, constructs) and returns the shared instance.
+         * @return The instance, which must not be modified.
+         */
+        inline static const TDerivedClass&  GetSingleton()
+        {
+            return *Segment::GetSingleton().instance;
+        }
+
+        /**
+         * Returns \c true if the instance is located in shared memory and \c false, if it was
+         * constructed in the heap of this process.
+         * @return Whether the instance is shared.
+         */
+        static bool                         IsShared()
+        {
+            return Segment::GetSingleton().shared;
+        }
+
+        /**
+         * Removes the name of the shared memory segment. Processes that are attached to the
+         * segment keep using it, while the next request of a process that is not attached
+         * creates a new segment. The memory is freed when the last process detached.
+         */
+        static void                         Unlink()
+        {
+            unlinkSharedSegment( Name().name );
+        }
+};// class SharedSingleton
+
+}} // namespace aworx[::lib::singletons]
+
+/// Type alias in namespace #aworx.
+template<typename T, std::uint32_t TVersion= 0>
+using SharedSingleton=    aworx::lib::singletons::SharedSingleton<T, TVersion>;
+
+} // namespace aworx
+
+#endif // HPP_ALIB_SINGLETONS_SHAREDSINGLETON
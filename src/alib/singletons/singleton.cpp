@@ -6,6 +6,10 @@
 // #################################################################################################
 #include "alib/singletons/singleton.hpp"
 
+#if !defined (HPP_ALIB_SINGLETONS_INITIALIZATION)
+#   include "alib/singletons/initialization.hpp"
+#endif
+
 #if !defined (_GLIBCXX_CSTRING) && !defined(_CSTRING_)
 #   include <cstring>
 #endif
@@ -13,16 +17,68 @@
 #   include <mutex>
 #endif
 
-#if !defined (_GLIBCXX_MUTEX) && !defined(_MUTEX_)
-#   include <mutex>
+#if !defined (_GLIBCXX_ATOMIC) && !defined(_ATOMIC_)
+#   include <atomic>
 #endif
 
 #if !defined (_ASSERT_H) && !defined(assert)
 #   include <assert.h>
 #endif
 
+#if !defined (_GLIBCXX_THREAD) && !defined(_THREAD_)
+#   include <thread>
+#endif
+
+#if !defined (_GLIBCXX_VECTOR) && !defined(_VECTOR_)
+#   include <vector>
+#endif
+
+#if !defined (_GLIBCXX_CSTDINT) && !defined(_CSTDINT_)
+#   include <cstdint>
+#endif
+
+#if !defined (_GLIBCXX_LIMITS) && !defined(_LIMITS_)
+#   include <limits>
+#endif
+
 #if ALIB_FEAT_SINGLETON_MAPPED
 #   include "alib/lib/typemap.hpp"
+#   include "alib/lib/flattypemap.hpp"
+#   if !defined (_GLIBCXX_CONDITION_VARIABLE) && !defined(_CONDITION_VARIABLE_)
+#      include <condition_variable>
+#   endif
+#   if !defined (_GLIBCXX_CSTDLIB) && !defined(_CSTDLIB_)
+#      include <cstdlib>
+#   endif
+#   if !defined (_GLIBCXX_QUEUE) && !defined(_QUEUE_)
+#      include <queue>
+#   endif
+#   if !defined (_GLIBCXX_ALGORITHM) && !defined(_ALGORITHM_)
+#      include <algorithm>
+#   endif
+#   if !defined (_GLIBCXX_CHRONO) && !defined(_CHRONO_)
+#      include <chrono>
+#   endif
+#endif
+
+#if ALIB_FEAT_SINGLETON_STATISTICS
+#   include "alib/singletons/statistics.hpp"
+#endif
+
+#if defined(__linux__)
+#   include <linux/membarrier.h>
+#   include <sys/syscall.h>
+#   include <unistd.h>
+#endif
+
+#if ALIB_FEAT_SINGLETON_MAPPED
+#   if defined(_WIN32)
+#      if !defined(_WINDOWS_)
+#         include <windows.h>
+#      endif
+#   elif defined(__unix__) || defined(__APPLE__)
+#      include <dlfcn.h>
+#   endif
 #endif
 
 namespace aworx { namespace lib {
@@ -37,68 +93,1420 @@ namespace singletons {
 
 //! @cond NO_DOX
 
+/** The list of registrations of singletons for eager initialization. */
+extern SingletonRegistration*   singletonRegistrations;
+       SingletonRegistration*   singletonRegistrations= nullptr;
+
+/** Guards #singletonRegistrations. */
+extern std::mutex               singletonRegistrationsLock;
+       std::mutex               singletonRegistrationsLock;
+
+ALIB_API std::atomic<std::size_t>   singletonGeneration( 1 );
+
+namespace {
+
+/**
+ * Returns the threads started with #startBackgroundConstruction.
+ * (Never destructed, as joinable threads must not be destructed if the process exits without
+ * invoking #DeleteSingletons.)
+ * @return The threads.
+ */
+std::vector<std::thread>& backgroundThreads()
+{
+    static std::vector<std::thread>* threads= new std::vector<std::thread>();
+    return *threads;
+}
+
+/** Guards #backgroundThreads. */
+std::mutex                      backgroundThreadsLock;
+
+/** Joins the threads started with #startBackgroundConstruction. */
+void joinBackgroundConstructions()
+{
+    // joined threads might have started further threads
+    for(;;)
+    {
+        std::vector<std::thread> threads;
+        {
+            std::lock_guard<std::mutex> guard( backgroundThreadsLock );
+            threads.swap( backgroundThreads() );
+        }
+        if( threads.empty() )
+            return;
+
+        for( auto& thread : threads )
+            thread.join();
+    }
+}
+
+} // anonymous namespace
+
+void  startBackgroundConstruction( void (*task)( void* ), void* data )
+{
+    std::lock_guard<std::mutex> guard( backgroundThreadsLock );
+    backgroundThreads().emplace_back( task, data );
+}
+
+// #################################################################################################
+// Epoch-based reclamation of replaced singletons
+// #################################################################################################
+namespace {
+
+/**
+ * The read section state of a thread. Records are never freed, but reused by other threads
+ * once their thread exited.
+ */
+struct ReaderRecord
+{
+    std::atomic<std::uint64_t>  epoch;      ///< The epoch the read section started in. \c 0 if none.
+    std::atomic<bool>           used;       ///< Denotes if the record is owned by a thread.
+    ReaderRecord*               next;       ///< The record created before.
+    char                        padding[64 - sizeof(std::uint64_t) - sizeof(void*) * 2]; ///< Avoids false sharing.
+};
+
+/** A replaced singleton, waiting for the readers of its epoch. */
+struct RetiredSingleton
+{
+    void*                       singleton;  ///< The singleton.
+    void                      (*deleter)( void* ); ///< Destructs and frees #singleton.
+    std::uint64_t               epoch;      ///< The epoch started with the replacement.
+    RetiredSingleton*           next;       ///< The singleton retired before.
+};
+
+/** The current epoch. Incremented with each replacement. */
+std::atomic<std::uint64_t>      globalEpoch( 1 );
+
+/** The list of reader records. Records are only added. */
+std::atomic<ReaderRecord*>      readerRecords( nullptr );
+
+/** The list of retired singletons. Guarded by #retiredLock. */
+RetiredSingleton*               retiredSingletons= nullptr;
+
+/** The number of retired singletons. Allows readers to skip reclamation without locking. */
+std::atomic<std::size_t>        retiredCount( 0 );
+
+/** The epoch started with the latest replacement. */
+std::atomic<std::uint64_t>      retiredEpoch( 0 );
+
+/** Guards #retiredSingletons. */
+std::mutex                      retiredLock;
+
+/** The reader record of a thread, released when the thread exits. */
+struct ReaderHandle
+{
+    ReaderRecord*   record;     ///< The record. \c nullptr until the first read section.
+    unsigned int    nesting;    ///< The depth of nested read sections.
+    bool            asymmetric; ///< The result of #asymmetricFences.
+
+    /** Destructor. Releases the record. */
+    ~ReaderHandle()
+    {
+        if( record != nullptr )
+            record->used.store( false, std::memory_order_release );
+    }
+};
+
+thread_local ReaderHandle       readerHandle= { nullptr, 0, false };
+
+/**
+ * Detects if system call \c membarrier (GNU/Linux 4.14 and higher) is available, which issues
+ * a memory barrier on all threads of the process. Then, read sections need only a compiler
+ * barrier, while reclamation issues the memory barrier on behalf of the readers.
+ * @return \c true if \c membarrier is used.
+ */
+bool asymmetricFences()
+{
+    #if defined(__linux__) && defined(SYS_membarrier)
+        static const bool available=
+            syscall( SYS_membarrier, MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED, 0 ) == 0;
+        return available;
+    #else
+        return false;
+    #endif
+}
+
+/**
+ * Returns an unused reader record, or creates one.
+ * @return The record, owned by the calling thread.
+ */
+ReaderRecord* acquireReaderRecord()
+{
+    for( ReaderRecord* record= readerRecords.load( std::memory_order_acquire ) ;
+         record != nullptr ;
+         record= record->next )
+    {
+        bool expected= false;
+        if(    !record->used.load( std::memory_order_relaxed )
+            &&  record->used.compare_exchange_strong( expected, true, std::memory_order_acquire ) )
+            return record;
+    }
+
+    ReaderRecord* record= new ReaderRecord();
+    record->epoch.store( 0, std::memory_order_relaxed );
+    record->used .store( true, std::memory_order_relaxed );
+    record->next= readerRecords.load( std::memory_order_relaxed );
+    while( !readerRecords.compare_exchange_weak( record->next, record, std::memory_order_release,
+                                                                        std::memory_order_relaxed ) )
+    {}
+    return record;
+}
+
+/**
+ * Deletes the retired singletons that no read section may use any more.
+ * @param force If \c true, read sections are ignored and all retired singletons are deleted.
+ *              Otherwise, nothing is done if another thread reclaims.
+ */
+void reclaimSingletons( bool force )
+{
+    RetiredSingleton* reclaimed= nullptr;
+    {
+        std::unique_lock<std::mutex> lock( retiredLock, std::try_to_lock );
+        if( !lock.owns_lock() )
+        {
+            if( !force )
+                return;
+            lock.lock();
+        }
+
+        // the oldest epoch a read section started in
+        std::uint64_t oldest= std::numeric_limits<std::uint64_t>::max();
+        #if defined(__linux__) && defined(SYS_membarrier)
+            if( asymmetricFences() )
+                syscall( SYS_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0 );
+            else
+        #endif
+                std::atomic_thread_fence( std::memory_order_seq_cst );
+        if( !force )
+            for( ReaderRecord* record= readerRecords.load( std::memory_order_acquire ) ;
+                 record != nullptr ;
+                 record= record->next )
+            {
+                std::uint64_t epoch= record->epoch.load( std::memory_order_acquire );
+                if( epoch != 0 && epoch < oldest )
+                    oldest= epoch;
+            }
+
+        // sections that started in or after the epoch of a replacement received the new singleton
+        for( RetiredSingleton** it= &retiredSingletons ; *it != nullptr ; )
+            if( (*it)->epoch <= oldest )
+            {
+                RetiredSingleton* retired= *it;
+                *it= retired->next;
+                retired->next= reclaimed;
+                reclaimed= retired;
+                retiredCount.fetch_sub( 1, std::memory_order_relaxed );
+            }
+            else
+                it= &(*it)->next;
+    }
+
+    // destructors might replace singletons
+    while( reclaimed != nullptr )
+    {
+        RetiredSingleton* next= reclaimed->next;
+        reclaimed->deleter( reclaimed->singleton );
+        delete reclaimed;
+        reclaimed= next;
+    }
+}
+
+} // anonymous namespace
+
+void  retireSingleton( void* theSingleton, void (*deleter)( void* ) )
+{
+    // the singleton was replaced before: sections starting from now on receive the new one
+    std::uint64_t epoch= globalEpoch.fetch_add( 1, std::memory_order_seq_cst ) + 1;
+    {
+        std::lock_guard<std::mutex> guard( retiredLock );
+        retiredSingletons= new RetiredSingleton{ theSingleton, deleter, epoch, retiredSingletons };
+        retiredCount.fetch_add( 1, std::memory_order_relaxed );
+        retiredEpoch.store( epoch, std::memory_order_relaxed );
+    }
+    reclaimSingletons( false );
+}
+
+void  enterSingletonReadSection()
+{
+    ReaderHandle& handle= readerHandle;
+    if( handle.nesting++ != 0 )
+        return;
+
+    if( handle.record == nullptr )
+    {
+        handle.record    = acquireReaderRecord();
+        handle.asymmetric= asymmetricFences();
+    }
+
+    // the fence orders the publication of the epoch before the loads of singletons
+    handle.record->epoch.store( globalEpoch.load( std::memory_order_acquire ),
+                                std::memory_order_relaxed );
+    if( handle.asymmetric )
+        std::atomic_signal_fence( std::memory_order_seq_cst );
+    else
+        std::atomic_thread_fence( std::memory_order_seq_cst );
+}
+
+void  leaveSingletonReadSection()
+{
+    ReaderHandle& handle= readerHandle;
+    assert( handle.nesting > 0 ); // Read section not entered
+    if( --handle.nesting != 0 )
+        return;
+
+    // only sections that started before a replacement might have delayed a reclamation
+    std::uint64_t epoch= handle.record->epoch.load( std::memory_order_relaxed );
+    handle.record->epoch.store( 0, std::memory_order_release );
+    if(    retiredCount.load( std::memory_order_relaxed ) != 0
+        && epoch < retiredEpoch.load( std::memory_order_relaxed ) )
+        reclaimSingletons( false );
+}
+
 #if ALIB_FEAT_SINGLETON_MAPPED
 
-extern ALIB_API TypeMap<void*>  singletonMap;
-       ALIB_API TypeMap<void*>  singletonMap;
+#if ALIB_FEAT_SINGLETON_STATISTICS
+/**
+ * The statistics of a singleton type. Created with the first creation of the type and kept
+ * until #DeleteSingletons. Apart from #lookups, fields are modified only while #singletonLock
+ * is acquired.
+ */
+struct StatisticsRecord
+{
+    const TypeKey*                          type;               ///< The singleton's type.
+    void*                                   singleton;          ///< The singleton. \c nullptr if deleted.
+    std::size_t                             sequence;           ///< The creation order.
+    std::size_t                             creations;          ///< The number of creations.
+    std::thread::id                         creator;            ///< The constructing thread.
+    std::chrono::steady_clock::time_point   created;            ///< The start of the construction.
+    std::chrono::nanoseconds                constructionTime;   ///< The duration of the construction.
+    std::atomic<std::size_t>                lookups;            ///< The number of registry lookups.
+    std::chrono::nanoseconds                lockWaitTime;       ///< The time waited for the lock.
+    StatisticsRecord*                       next;               ///< The record created before.
 
-extern std::recursive_mutex     singletonLock;
-       std::recursive_mutex     singletonLock;
+    /**
+     * Constructor.
+     * @param pType The singleton's type.
+     * @param pNext The record created before.
+     */
+    StatisticsRecord( const TypeKey& pType, StatisticsRecord* pNext )
+    : type            ( &pType )
+    , singleton       ( nullptr )
+    , sequence        ( 0 )
+    , creations       ( 0 )
+    , constructionTime( 0 )
+    , lookups         ( 0 )
+    , lockWaitTime    ( 0 )
+    , next            ( pNext )
+    {}
+};
 
-bool getSingleton  ( const std::type_info& type, void* theSingleton )
+/** The statistics records, the latest created first. */
+extern std::atomic<StatisticsRecord*>   statisticsRecords;
+       std::atomic<StatisticsRecord*>   statisticsRecords( nullptr );
+
+/** The statistics of #singletonLock. Modified only while the lock is acquired. */
+extern SingletonLockStatistics          lockStatistics;
+       SingletonLockStatistics          lockStatistics= { 0, 0, std::chrono::nanoseconds( 0 ) };
+#endif
+
+/**
+ * A pointer that caches a singleton in a code entity, as passed to #getSingleton.
+ * It is reset to \c nullptr when the singleton is removed.
+ */
+struct CacheSlot
+{
+    std::atomic<void*>*                 cache;      ///< The pointer of the code entity.
+    CacheSlot*                          next;       ///< The next slot of the singleton.
+};
+
+/**
+ * A copy of a type key, owned by the registry. Keys passed to the registry may be located in
+ * a shared library, which might be unloaded while the registry entry persists.
+ */
+struct InternedTypeKey
 {
-    singletonLock.lock();
-    auto entry= singletonMap.find( type );
-    if ( entry != singletonMap.end() )
+    TypeKey                             key;        ///< The copy. Its name follows this struct.
+    InternedTypeKey*                    next;       ///< The key interned before.
+
+    /**
+     * Constructor.
+     * @param name  The copy of the name.
+     * @param type  The key to copy.
+     * @param pNext The key interned before.
+     */
+    InternedTypeKey( const char* name, const TypeKey& type, InternedTypeKey* pNext )
+    : key ( name, type.NameLength(), type.Local(), type.Hash() )
+    , next( pNext )
+    {}
+};
+
+/**
+ * An entry of the singleton registry.
+ * Field #type is written last (with release semantics) and once written, it is never changed.
+ * Hence, readers that see a type are guaranteed to see the entry's hash code.
+ * Removed singletons leave the entry in place, with a \c nullptr in field #singleton.
+ */
+struct RegistryEntry
+{
+    std::atomic<const TypeKey*>         type;       ///< The key. \c nullptr for unused entries.
+    std::size_t                         hashCode;   ///< The hash code of #type (avoids dereferencing it).
+    std::atomic<void*>                  singleton;  ///< The singleton. \c nullptr if removed.
+    std::size_t                         sequence;   ///< The creation order of #singleton.
+    void                              (*deleter)( void* ); ///< Destructs and frees #singleton.
+    std::thread::id                     creator;    ///< The thread that created #singleton.
+    CacheSlot*                          caches;     ///< The pointers that cache #singleton.
+    #if ALIB_FEAT_SINGLETON_STATISTICS
+    StatisticsRecord*                   statistics; ///< The statistics of #type. Set with #type.
+    #endif
+
+    /** Constructor. */
+    RegistryEntry()
+    : type     ( nullptr )
+    , hashCode ( 0 )
+    , singleton( nullptr )
+    , sequence ( 0 )
+    , deleter  ( nullptr )
+    , caches   ( nullptr )
+    #if ALIB_FEAT_SINGLETON_STATISTICS
+    , statistics( nullptr )
+    #endif
+    {}
+};
+
+/**
+ * Open-addressing hash table with linear probing, used as the singleton registry.
+ *
+ * Lookups are lock-free. Modifications are performed only while #singletonLock is acquired.
+ * The table is never filled above half of its capacity. If it has to grow, a new table is
+ * created and published (RCU style), while the old one remains valid for readers that
+ * still use it. Retired tables are freed only with #DeleteSingletons.
+ */
+struct RegistryTable
+{
+    std::size_t     mask;       ///< The capacity minus one. The capacity is a power of 2.
+    std::size_t     usage;      ///< The number of used entries (including removed singletons).
+    RegistryEntry*  entries;    ///< The entries.
+    RegistryTable*  retired;    ///< The table that was replaced by this one.
+
+    /**
+     * Constructor.
+     * @param capacity  The number of entries. Has to be a power of 2.
+     * @param previous  The table replaced by this one.
+     */
+    RegistryTable( std::size_t capacity, RegistryTable* previous )
+    : mask   ( capacity - 1 )
+    , usage  ( 0 )
+    , entries( new RegistryEntry[capacity] )
+    , retired( previous )
+    {}
+
+    /** Destructor. Deletes the entries and all retired tables. */
+    ~RegistryTable()
     {
-        memcpy( theSingleton, &entry->second, sizeof(void*) );
+        delete[] entries;
+        delete   retired;
+    }
 
-        singletonLock.unlock();
-        return true;
+    /**
+     * Searches the entry of the given type, or, if not found, the unused entry that terminates
+     * the probe sequence.
+     * @param type      The type to search.
+     * @return The entry found.
+     */
+    RegistryEntry& Find( const TypeKey& type )
+    {
+        std::size_t hashCode= type.Hash();
+        for( std::size_t idx= hashCode & mask ;; idx= (idx + 1) & mask )
+        {
+            RegistryEntry& entry= entries[idx];
+            const TypeKey* entryType= entry.type.load( std::memory_order_acquire );
+            if(     entryType == nullptr
+                || ( entry.hashCode == hashCode && *entryType == type ) )
+                return entry;
+        }
     }
+};
+
+extern std::atomic<RegistryTable*>  singletonTable;
+       std::atomic<RegistryTable*>  singletonTable( nullptr );
+
+/** The keys owned by the registry. Modified only while #singletonLock is acquired. */
+extern InternedTypeKey*             internedTypeKeys;
+       InternedTypeKey*             internedTypeKeys= nullptr;
+
+/** The number of singletons stored so far. Modified only while #singletonLock is acquired. */
+extern std::size_t                  singletonSequence;
+       std::size_t                  singletonSequence= 0;
+
+/** The singleton currently deleted by this thread with DeleteSingletons. Not removed from the registry. */
+extern thread_local void*           bulkDeletedSingleton;
+       thread_local void*           bulkDeletedSingleton= nullptr;
+
+/**
+ * A singleton that is currently constructed by thread #owner.
+ * Other threads that request the same singleton wait on #constructed.
+ */
+struct InFlight
+{
+    std::thread::id             owner;       ///< The thread that constructs the singleton.
+    std::condition_variable     constructed; ///< Notified when the construction ended.
+    int                         waiters;     ///< The number of threads waiting.
+    bool                        done;        ///< Set when the construction ended.
+    #if ALIB_FEAT_SINGLETON_STATISTICS
+    std::chrono::steady_clock::time_point started;      ///< The start of the construction.
+    std::chrono::nanoseconds              lockWaitTime; ///< The time the owner waited for the lock.
+    #endif
 
-    // we do not unlock when we have not found the singleton
-    return false;
+    /** Constructor. */
+    InFlight()
+    : owner  ( std::this_thread::get_id() )
+    , waiters( 0 )
+    , done   ( false )
+    #if ALIB_FEAT_SINGLETON_STATISTICS
+    , started     ( std::chrono::steady_clock::now() )
+    , lockWaitTime( 0 )
+    #endif
+    {}
+};
+
+/**
+ * Guards modifications of the registry and the bookkeeping of singletons under construction.
+ * The lock is never held while a singleton is constructed.
+ */
+extern std::mutex                   singletonLock;
+       std::mutex                   singletonLock;
+
+namespace {
+
+/**
+ * Returns the singletons currently under construction.
+ * (Constructed on first use, because singletons might be requested during static initialization.)
+ * @return The map of singletons under construction.
+ */
+TypeKeyMap<InFlight*>& inFlightSingletons()
+{
+    static TypeKeyMap<InFlight*> map;
+    return map;
+}
+
+/**
+ * Returns, for each thread that waits for a singleton under construction, the singleton's type.
+ * @return The map of waiting threads.
+ */
+std::unordered_map<std::thread::id, const TypeKey*>& waitingThreads()
+{
+    static std::unordered_map<std::thread::id, const TypeKey*> map;
+    return map;
+}
+
+/**
+ * Lock-free lookup of a singleton.
+ * @param type      The singleton's type.
+ * @return The singleton, \c nullptr if not registered.
+ */
+void* findSingleton( const TypeKey& type )
+{
+    RegistryTable* table= singletonTable.load( std::memory_order_acquire );
+    if( table == nullptr )
+        return nullptr;
+
+    return table->Find( type ).singleton.load( std::memory_order_acquire );
+}
+
+/**
+ * Lock-free lookup of a singleton requested with #getSingleton. With statistics, the lookup
+ * is counted.
+ * @param type      The singleton's type.
+ * @return The singleton, \c nullptr if not registered.
+ */
+void* lookupSingleton( const TypeKey& type )
+{
+    RegistryTable* table= singletonTable.load( std::memory_order_acquire );
+    if( table == nullptr )
+        return nullptr;
+
+    RegistryEntry& entry= table->Find( type );
+    void* result= entry.singleton.load( std::memory_order_acquire );
+    #if ALIB_FEAT_SINGLETON_STATISTICS
+        if( result != nullptr )
+            entry.statistics->lookups.fetch_add( 1, std::memory_order_relaxed );
+    #endif
+    return result;
+}
+
+/**
+ * Acquires \c singletonLock. With statistics, the wait is measured, in case the lock is
+ * owned by another thread.
+ * @param waitTime Receives the time waited. Only set with statistics.
+ * @return The acquired lock.
+ */
+std::unique_lock<std::mutex> lockRegistry( std::chrono::nanoseconds& waitTime )
+{
+    #if ALIB_FEAT_SINGLETON_STATISTICS
+        std::unique_lock<std::mutex> lock( singletonLock, std::try_to_lock );
+        if( !lock.owns_lock() )
+        {
+            std::chrono::steady_clock::time_point start= std::chrono::steady_clock::now();
+            lock.lock();
+            std::chrono::nanoseconds wait= std::chrono::steady_clock::now() - start;
+            waitTime               += wait;
+            lockStatistics.WaitTime+= wait;
+            ++lockStatistics.Contentions;
+        }
+        ++lockStatistics.Acquisitions;
+        return lock;
+    #else
+        (void) waitTime;
+        return std::unique_lock<std::mutex>( singletonLock );
+    #endif
 }
 
-void  storeSingleton( const std::type_info& type, void* theSingleton )
+/**
+ * Searches the entry of a singleton. Must be invoked only while \c singletonLock is acquired.
+ * @param type      The singleton's type.
+ * @return The entry, \c nullptr if the type was never registered.
+ */
+RegistryEntry* findEntry( const TypeKey& type )
 {
-    singletonMap[type]= theSingleton;
+    RegistryTable* table= singletonTable.load( std::memory_order_relaxed );
+    if( table == nullptr )
+        return nullptr;
+
+    RegistryEntry& entry= table->Find( type );
+    return entry.type.load( std::memory_order_relaxed ) != nullptr ? &entry : nullptr;
+}
 
-    // we unlock now as we were locked in getSingleton
-    singletonLock.unlock();
+/**
+ * Copies a type key into memory owned by the registry.
+ * Must be invoked only while \c singletonLock is acquired.
+ * @param type  The key to copy.
+ * @return The copy.
+ */
+const TypeKey* internTypeKey( const TypeKey& type )
+{
+    void* memory= ::operator new( sizeof(InternedTypeKey) + type.NameLength() );
+    char* name  = static_cast<char*>( memory ) + sizeof(InternedTypeKey);
+    std::memcpy( name, type.Name(), type.NameLength() );
+    internedTypeKeys= new ( memory ) InternedTypeKey( name, type, internedTypeKeys );
+    return &internedTypeKeys->key;
 }
 
-void  removeSingleton( const std::type_info& type )
+/**
+ * Stores \p{cached} in \p{cache} and adds \p{cache} to the pointers that cache the singleton of
+ * \p{entry}, unless added already.
+ * Must be invoked only while \c singletonLock is acquired. Hence, a concurrent
+ * #replaceSingleton or #removeSingleton either precedes the store and is overwritten with
+ * the current singleton, or follows it and updates the cache.
+ * @param entry  The entry of the singleton.
+ * @param cache  The pointer of a code entity. May be \c nullptr.
+ * @param cached The singleton, converted for \p{cache}.
+ */
+void addCache( RegistryEntry& entry, std::atomic<void*>* cache, void* cached )
 {
-    auto it= singletonMap.find(type);
-    assert( it != singletonMap.end() ); // Can not remove singleton: Singleton not found
-    singletonMap.erase( it );
+    if( cache == nullptr )
+        return;
+    cache->store( cached, std::memory_order_release );
+    for( CacheSlot* slot= entry.caches ; slot != nullptr ; slot= slot->next )
+        if( slot->cache == cache )
+            return;
+    entry.caches= new CacheSlot{ cache, entry.caches };
+}
+
+/**
+ * Resets the pointers that cache the singleton of \p{entry} and forgets them.
+ * Must be invoked only while \c singletonLock is acquired.
+ * @param entry The entry of the singleton.
+ */
+void resetCaches( RegistryEntry& entry )
+{
+    for( CacheSlot* slot= entry.caches ; slot != nullptr ; )
+    {
+        CacheSlot* next= slot->next;
+        slot->cache->store( nullptr, std::memory_order_release );
+        delete slot;
+        slot= next;
+    }
+    entry.caches= nullptr;
+}
+
+/**
+ * Grows the registry, if an insertion would fill it above half of its capacity.
+ * Must be invoked only while \c singletonLock is acquired.
+ * @return The table to insert into.
+ */
+RegistryTable* prepareInsertion()
+{
+    RegistryTable* table= singletonTable.load( std::memory_order_relaxed );
+    if( table != nullptr && ( table->usage + 1 ) * 2 <= table->mask + 1 )
+        return table;
+
+    RegistryTable* newTable= new RegistryTable( table ? ( table->mask + 1 ) * 2 : 16, table );
+    if( table != nullptr )
+        for( std::size_t idx= 0 ; idx <= table->mask ; ++idx )
+        {
+            RegistryEntry& entry=     table->entries[idx];
+            void*          singleton= entry.singleton.load( std::memory_order_relaxed );
+            const TypeKey* type     = entry.type     .load( std::memory_order_relaxed );
+            #if ALIB_FEAT_SINGLETON_STATISTICS
+                // entries of removed singletons are kept, as they refer to the statistics
+                if( type == nullptr )
+                    continue;
+            #else
+                if( singleton == nullptr )
+                    continue;
+            #endif
+
+            RegistryEntry& newEntry= newTable->Find( *type );
+            newEntry.hashCode= entry.hashCode;
+            newEntry.sequence= entry.sequence;
+            newEntry.deleter = entry.deleter;
+            newEntry.creator = entry.creator;
+            newEntry.caches  = entry.caches;
+            #if ALIB_FEAT_SINGLETON_STATISTICS
+                newEntry.statistics= entry.statistics;
+            #endif
+            newEntry.singleton.store( singleton, std::memory_order_relaxed );
+            newEntry.type     .store( type     , std::memory_order_relaxed );
+            ++newTable->usage;
+        }
+
+    singletonTable.store( newTable, std::memory_order_release );
+    return newTable;
+}
+
+/**
+ * Tests if waiting for the construction of a singleton would deadlock, because its constructing
+ * thread (directly or through a chain of other threads) waits for the current thread.
+ * Must be invoked only while \c singletonLock is acquired.
+ * @param inFlight  The singleton to wait for.
+ * @return \c true if a cycle was detected, \c false otherwise.
+ */
+bool isCyclic( InFlight* inFlight )
+{
+    std::thread::id self= std::this_thread::get_id();
+    for(;;)
+    {
+        if( inFlight->owner == self )
+            return true;
+
+        auto waiting= waitingThreads().find( inFlight->owner );
+        if( waiting == waitingThreads().end() )
+            return false;
+
+        // the construction waited for might have ended, while the woken thread has not
+        // re-acquired the lock, yet
+        auto awaited= inFlightSingletons().find( *waiting->second );
+        if( awaited == inFlightSingletons().end() )
+            return false;
+
+        inFlight= awaited->second;
+    }
+}
+
+/**
+ * Ends the construction of a singleton. Notifies waiting threads.
+ * Must be invoked only while \c singletonLock is acquired.
+ * @param type  The singleton's type.
+ */
+void endConstruction( const TypeKey& type )
+{
+    auto it= inFlightSingletons().find( type );
+    assert( it != inFlightSingletons().end() ); // Singleton not under construction
+    InFlight* inFlight= it->second;
+    inFlightSingletons().erase( it );
+
+    inFlight->done= true;
+    if( inFlight->waiters == 0 )
+        delete inFlight;
+    else
+        inFlight->constructed.notify_all();
+}
+
+} // anonymous namespace
+
+bool getSingleton  ( const TypeKey& type, void* theSingleton, std::atomic<void*>* cache,
+                     void* (*toCached)( void* ) )
+{
+    // the lock is acquired, if the singleton does not exist or if the cache has to be added
+    void* result= lookupSingleton( type );
+    if( result == nullptr || cache != nullptr )
+    {
+        bool                         counted= result != nullptr;
+        std::chrono::nanoseconds     waitTime( 0 );
+        std::unique_lock<std::mutex> lock= lockRegistry( waitTime );
+        for(;;)
+        {
+            // another thread might have stored the singleton in the meantime
+            RegistryEntry* entry= findEntry( type );
+            result= entry != nullptr ? entry->singleton.load( std::memory_order_relaxed ) : nullptr;
+            if( result != nullptr )
+            {
+                addCache( *entry, cache, cache != nullptr ? toCached( result ) : nullptr );
+                #if ALIB_FEAT_SINGLETON_STATISTICS
+                    if( !counted )
+                        entry->statistics->lookups.fetch_add( 1, std::memory_order_relaxed );
+                    if( waitTime.count() != 0 )
+                        entry->statistics->lockWaitTime+= waitTime;
+                #else
+                    (void) counted;
+                #endif
+                break;
+            }
+
+            // not under construction: the caller becomes the constructing thread
+            auto it= inFlightSingletons().find( type );
+            if( it == inFlightSingletons().end() )
+            {
+                InFlight* inFlight= new InFlight();
+                #if ALIB_FEAT_SINGLETON_STATISTICS
+                    inFlight->lockWaitTime= waitTime;
+                #endif
+                inFlightSingletons()[type]= inFlight;
+                return false;
+            }
+
+            // wait for the constructing thread
+            InFlight* inFlight= it->second;
+            if( isCyclic( inFlight ) )
+            {
+                lock.unlock();
+                assert( false ); // Cyclic dependency of singleton constructors detected
+                std::abort();
+            }
+
+            std::thread::id self= std::this_thread::get_id();
+            waitingThreads()[self]= &type;
+            ++inFlight->waiters;
+            while( !inFlight->done )
+                inFlight->constructed.wait( lock );
+            waitingThreads().erase( self );
+            if( --inFlight->waiters == 0 )
+                delete inFlight;
+
+            // loop: the construction might have been aborted
+        }
+    }
+
+    memcpy( theSingleton, &result, sizeof(void*) );
+    return true;
+}
+
+std::size_t  getSingletons( std::size_t count, const TypeKey* const* types, void** singletons,
+                            std::atomic<void*>* const* caches,
+                            void* (* const* toCached)( void* ) )
+{
+    // lock-free lookups first. The lock is acquired once, to add the caches of the singletons
+    // found. (Singletons not found are left to getSingleton, which acquires the lock anyhow.)
+    std::size_t resolved= 0;
+    std::size_t locked  = 0;
+    for( std::size_t idx= 0 ; idx < count ; ++idx )
+    {
+        singletons[idx]= lookupSingleton( *types[idx] );
+        if( singletons[idx] != nullptr )
+        {
+            ++resolved;
+            if( caches[idx] != nullptr )
+                ++locked;
+        }
+    }
+    if( locked == 0 )
+        return resolved;
+
+    std::chrono::nanoseconds     waitTime( 0 );
+    std::unique_lock<std::mutex> lock= lockRegistry( waitTime );
+    for( std::size_t idx= 0 ; idx < count ; ++idx )
+    {
+        if( singletons[idx] == nullptr || caches[idx] == nullptr )
+            continue;
+
+        // another thread might have removed the singleton in the meantime
+        RegistryEntry* entry= findEntry( *types[idx] );
+        void*          found= entry != nullptr ? entry->singleton.load( std::memory_order_relaxed )
+                                               : nullptr;
+        if( found != singletons[idx] )
+        {
+            singletons[idx]= nullptr;
+            --resolved;
+            continue;
+        }
+
+        addCache( *entry, caches[idx], toCached[idx]( found ) );
+        #if ALIB_FEAT_SINGLETON_STATISTICS
+            entry->statistics->lockWaitTime+= waitTime / locked;
+        #endif
+    }
+    return resolved;
+}
+
+void  storeSingleton( const TypeKey& type, void* theSingleton, void (*deleter)( void* ),
+                      std::atomic<void*>* cache, void* cached )
+{
+    #if ALIB_FEAT_SINGLETON_STATISTICS
+        std::chrono::steady_clock::time_point stored= std::chrono::steady_clock::now();
+    #endif
+
+    std::chrono::nanoseconds     waitTime( 0 );
+    std::unique_lock<std::mutex> lock= lockRegistry( waitTime );
+    RegistryTable* table= prepareInsertion();
+    RegistryEntry& entry= table->Find( type );
+    entry.sequence= ++singletonSequence;
+    entry.deleter = deleter;
+    entry.creator = std::this_thread::get_id();
+    addCache( entry, cache, cached );
+    if( entry.type.load( std::memory_order_relaxed ) == nullptr )
+    {
+        const TypeKey* interned= internTypeKey( type );
+        entry.hashCode= type.Hash();
+        #if ALIB_FEAT_SINGLETON_STATISTICS
+            entry.statistics= new StatisticsRecord( *interned, statisticsRecords.load( std::memory_order_relaxed ) );
+            statisticsRecords.store( entry.statistics, std::memory_order_release );
+        #endif
+        entry.singleton.store( theSingleton, std::memory_order_relaxed );
+        entry.type     .store( interned    , std::memory_order_release );
+        ++table->usage;
+    }
+    else
+        entry.singleton.store( theSingleton, std::memory_order_release );
+
+    #if ALIB_FEAT_SINGLETON_STATISTICS
+        InFlight*         inFlight  = inFlightSingletons().find( type )->second;
+        StatisticsRecord& statistics= *entry.statistics;
+        statistics.singleton       = theSingleton;
+        statistics.sequence        = entry.sequence;
+        statistics.creator         = inFlight->owner;
+        statistics.created         = inFlight->started;
+        statistics.constructionTime= stored - inFlight->started;
+        statistics.lockWaitTime   += inFlight->lockWaitTime + waitTime;
+        ++statistics.creations;
+    #endif
+
+    endConstruction( type );
+}
+
+void  abortSingleton( const TypeKey& type )
+{
+    std::chrono::nanoseconds     waitTime( 0 );
+    std::unique_lock<std::mutex> lock= lockRegistry( waitTime );
+    endConstruction( type );
+}
+
+void  removeSingleton( const TypeKey& type, void* theSingleton )
+{
+    if( theSingleton == bulkDeletedSingleton )
+        return;
+
+    std::chrono::nanoseconds     waitTime( 0 );
+    std::unique_lock<std::mutex> lock= lockRegistry( waitTime );
+    RegistryTable* table= singletonTable.load( std::memory_order_relaxed );
+    if( table == nullptr )
+        return;
+
+    // other instances of a singleton type (non-strict singletons, or a singleton whose
+    // constructor threw) are not registered
+    RegistryEntry& entry= table->Find( type );
+    if( entry.singleton.load( std::memory_order_relaxed ) == theSingleton )
+    {
+        entry.singleton.store( nullptr, std::memory_order_release );
+        resetCaches( entry );
+        #if ALIB_FEAT_SINGLETON_STATISTICS
+            entry.statistics->singleton= nullptr;
+        #endif
+        singletonGeneration.fetch_add( 1, std::memory_order_release );
+    }
+}
+
+void* replaceSingleton( const TypeKey& type, void* theSingleton, void* cached,
+                        void (*deleter)( void* ), void (**oldDeleter)( void* ) )
+{
+    std::chrono::nanoseconds     waitTime( 0 );
+    std::unique_lock<std::mutex> lock= lockRegistry( waitTime );
+    RegistryEntry* entry= findEntry( type );
+    void* old= entry != nullptr ? entry->singleton.load( std::memory_order_relaxed ) : nullptr;
+    if( old == nullptr )
+        return nullptr;
+
+    *oldDeleter= entry->deleter;
+    entry->deleter= deleter;
+    entry->singleton.store( theSingleton, std::memory_order_release );
+    for( CacheSlot* slot= entry->caches ; slot != nullptr ; slot= slot->next )
+        slot->cache->store( cached, std::memory_order_release );
+    #if ALIB_FEAT_SINGLETON_STATISTICS
+        entry->statistics->singleton= theSingleton;
+    #endif
+    singletonGeneration.fetch_add( 1, std::memory_order_release );
+    return old;
 }
 
 #endif  //ALIB_FEAT_SINGLETON_MAPPED
 
-void DeleteSingletons()
+#if ALIB_FEAT_SINGLETON_MAPPED
+namespace {
+
+/** A singleton to be deleted by DeleteSingletons. */
+struct TeardownEntry
+{
+    const TypeKey*  type;                   ///< The singleton's type.
+    void*           singleton;              ///< The singleton.
+    std::size_t     sequence;               ///< The creation order of the singleton.
+    void          (*deleter)( void* );      ///< Destructs and frees the singleton.
+};
+
+/**
+ * Deletes a singleton, unless it was deleted (by another destructor) in the meantime.
+ * The registry is not updated.
+ * @param entry The singleton to delete.
+ */
+void deleteSingleton( const TeardownEntry& entry )
+{
+    if( findSingleton( *entry.type ) != entry.singleton )
+        return;
+
+    bulkDeletedSingleton= entry.singleton;
+    entry.deleter( entry.singleton );
+    bulkDeletedSingleton= nullptr;
+}
+
+/**
+ * Deletes the given singletons in reverse order of creation and dependencies.
+ * Must be invoked only while registrations exist.
+ * @param entries     The singletons, sorted by creation order.
+ * @param threadCount The number of threads to use.
+ */
+void deleteSingletons( const std::vector<TeardownEntry>& entries, unsigned int threadCount )
 {
+    const std::size_t Deleted= static_cast<std::size_t>( -1 );
+
+    // for each singleton, the number of dependents not deleted, yet, and its dependencies
+    std::vector<std::size_t>                dependents  ( entries.size(), 0 );
+    std::vector<std::vector<std::size_t>>   dependencies( entries.size() );
+
+    // dependencies declared with registrations
+    FlatTypeMap<std::size_t, lib::TypeKey> index;
+    index.reserve( entries.size() );
+    for( std::size_t idx= 0 ; idx < entries.size() ; ++idx )
+        index.emplace( *entries[idx].type, idx );
+
+    std::vector<bool> registered( entries.size(), false );
+    {
+        std::lock_guard<std::mutex> guard( singletonRegistrationsLock );
+        for( SingletonRegistration* it= singletonRegistrations ; it != nullptr ; it= it->next )
+        {
+            auto node= index.find( it->Type() );
+            if( node == index.end() )
+                continue;
+
+            registered[node->second]= true;
+            for( auto* dependency= it->Dependencies ; *dependency ; ++dependency )
+            {
+                auto dependencyNode= index.find( (*dependency)() );
+                if( dependencyNode != index.end() && dependencyNode->second != node->second )
+                    dependencies[node->second].push_back( dependencyNode->second );
+            }
+        }
+    }
+
+    // singletons that are not registered depend on all singletons created before them.
+    // (Those created before the previous unregistered one are transitive dependencies.)
+    std::size_t chainStart= 0;
+    for( std::size_t idx= 0 ; idx < entries.size() ; ++idx )
+        if( !registered[idx] )
+        {
+            for( std::size_t dependency= chainStart ; dependency < idx ; ++dependency )
+                dependencies[idx].push_back( dependency );
+            chainStart= idx;
+        }
+
+    for( auto& nodeDependencies : dependencies )
+        for( std::size_t dependency : nodeDependencies )
+            ++dependents[dependency];
+
+    // the latest created singletons are deleted first
+    std::priority_queue<std::size_t> ready;
+    for( std::size_t idx= 0 ; idx < entries.size() ; ++idx )
+        if( dependents[idx] == 0 )
+            ready.push( idx );
+
+    std::mutex              lock;
+    std::condition_variable changed;
+    std::size_t             inProgress= 0;
+    auto worker= [&]()
+    {
+        std::unique_lock<std::mutex> guard( lock );
+        for(;;)
+        {
+            while( ready.empty() && inProgress > 0 )
+                changed.wait( guard );
+
+            // all deleted, or the remaining nodes are cyclic
+            if( ready.empty() )
+                return;
+
+            std::size_t idx= ready.top();
+            ready.pop();
+            ++inProgress;
+
+            guard.unlock();
+            deleteSingleton( entries[idx] );
+            guard.lock();
+
+            --inProgress;
+            dependents[idx]= Deleted;
+            for( std::size_t dependency : dependencies[idx] )
+                if( --dependents[dependency] == 0 )
+                    ready.push( dependency );
+            changed.notify_all();
+        }
+    };
+
+    if( threadCount > entries.size() )
+        threadCount= static_cast<unsigned int>( entries.size() );
+
+    std::vector<std::thread> threads;
+    for( unsigned int i= 1 ; i < threadCount ; ++i )
+        threads.emplace_back( worker );
+    worker();
+    for( auto& thread : threads )
+        thread.join();
+
+    // declared dependencies that contradict the creation order: delete the rest in reverse order
+    for( std::size_t idx= entries.size() ; idx > 0 ; --idx )
+        if( dependents[idx - 1] != Deleted )
+            deleteSingleton( entries[idx - 1] );
+}
+
+/**
+ * Returns the code entity (executable or shared library) that contains \p{address}.
+ * Must not be invoked while \c singletonLock is acquired, because the dynamic loader holds its
+ * own lock while static objects of a library are initialized, which might request singletons.
+ * @param address An address of a function or of an object with static storage duration.
+ * @return The base address of the code entity. \c nullptr if not detected.
+ */
+const void* moduleOf( const void* address )
+{
+    #if defined(_WIN32)
+        HMODULE module;
+        if( GetModuleHandleExA(   GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS
+                                | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
+                                static_cast<LPCSTR>( address ), &module ) )
+            return module;
+        return nullptr;
+    #elif defined(__unix__) || defined(__APPLE__)
+        Dl_info info;
+        if( dladdr( address, &info ) != 0 )
+            return info.dli_fbase;
+        return nullptr;
+    #else
+        (void) address;
+        return nullptr;
+    #endif
+}
+
+/**
+ * Forgets the given pointers of a code entity that is unloaded, without resetting them.
+ * Must be invoked only while \c singletonLock is acquired.
+ * @param slots The pointers to forget.
+ */
+void forgetCaches( const std::vector<std::atomic<void*>*>& slots )
+{
+    RegistryTable* table= singletonTable.load( std::memory_order_relaxed );
+    for( std::size_t idx= 0 ; idx <= table->mask ; ++idx )
+        for( CacheSlot** it= &table->entries[idx].caches ; *it != nullptr ; )
+            if( std::find( slots.begin(), slots.end(), (*it)->cache ) != slots.end() )
+            {
+                CacheSlot* slot= *it;
+                *it= slot->next;
+                delete slot;
+            }
+            else
+                it= &(*it)->next;
+}
+
+} // anonymous namespace
+#endif  //ALIB_FEAT_SINGLETON_MAPPED
+
+void DeleteSingletons( unsigned int threadCount )
+{
+    joinBackgroundConstructions();
+    reclaimSingletons( true );
+
     #if ALIB_FEAT_SINGLETON_MAPPED
-        while (!singletonMap.empty())
+        if( threadCount == 0 )
+            threadCount= std::thread::hardware_concurrency();
+
+        // destructors might create new singletons, which are deleted with the next round
+        std::size_t deleted= 0;
+        for(;;)
+        {
+            std::vector<TeardownEntry> entries;
+            {
+                std::lock_guard<std::mutex> guard( singletonLock );
+                RegistryTable* table= singletonTable.load( std::memory_order_relaxed );
+                if( table != nullptr )
+                    for( std::size_t idx= 0 ; idx <= table->mask ; ++idx )
+                    {
+                        RegistryEntry& entry= table->entries[idx];
+                        void* singleton= entry.singleton.load( std::memory_order_relaxed );
+                        if( singleton != nullptr && entry.sequence > deleted )
+                            entries.push_back( TeardownEntry{ entry.type.load( std::memory_order_relaxed ),
+                                                              singleton, entry.sequence, entry.deleter } );
+                    }
+            }
+
+            if( entries.empty() )
+                break;
+
+            std::sort( entries.begin(), entries.end(),
+                       []( const TeardownEntry& lhs, const TeardownEntry& rhs )
+                       {
+                           return lhs.sequence < rhs.sequence;
+                       } );
+            deleted= entries.back().sequence;
+
+            // without registrations, each singleton depends on all that were created before
+            bool hasRegistrations;
+            {
+                std::lock_guard<std::mutex> guard( singletonRegistrationsLock );
+                hasRegistrations= singletonRegistrations != nullptr;
+            }
+            if( hasRegistrations )
+                deleteSingletons( entries, threadCount );
+            else
+                for( std::size_t idx= entries.size() ; idx > 0 ; --idx )
+                    deleteSingleton( entries[idx - 1] );
+        }
+
+        // reset the pointers of code entities and free the keys
+        RegistryTable* table= singletonTable.load( std::memory_order_relaxed );
+        if( table != nullptr )
+            for( std::size_t idx= 0 ; idx <= table->mask ; ++idx )
+                resetCaches( table->entries[idx] );
+        delete table;
+        singletonTable.store( nullptr, std::memory_order_relaxed );
+        for( InternedTypeKey* key= internedTypeKeys ; key != nullptr ; )
         {
-            Singleton<void*>* theSingleton;
-            memcpy( &theSingleton, &singletonMap.begin()->second, sizeof(void*) );
-            delete theSingleton; // the virtual destructor removes the singleton from the map.
+            InternedTypeKey* next= key->next;
+            key->~InternedTypeKey();
+            ::operator delete( key );
+            key= next;
         }
-        singletonMap.clear();
+        internedTypeKeys= nullptr;
+        #if ALIB_FEAT_SINGLETON_STATISTICS
+            for( StatisticsRecord* record= statisticsRecords.load( std::memory_order_relaxed ) ; record ; )
+            {
+                StatisticsRecord* next= record->next;
+                delete record;
+                record= next;
+            }
+            statisticsRecords.store( nullptr, std::memory_order_relaxed );
+        #endif
+        releaseArenas();
+    #else
+        (void) threadCount;
     #endif
+
+    singletonGeneration.fetch_add( 1, std::memory_order_release );
+}
+
+#if ALIB_FEAT_SINGLETON_MAPPED
+std::size_t DeleteModuleSingletons( const void* address )
+{
+    const void* module= moduleOf( address );
+    if( module == nullptr )
+        return 0;
+
+    // background constructions might execute code of the module
+    joinBackgroundConstructions();
+
+    // replaced singletons of the module are deleted regardless of read sections
+    RetiredSingleton* retired;
+    {
+        std::lock_guard<std::mutex> guard( retiredLock );
+        retired= retiredSingletons;
+        retiredSingletons= nullptr;
+    }
+    std::size_t count= 0;
+    for( RetiredSingleton* next ; retired != nullptr ; retired= next )
+    {
+        next= retired->next;
+        if( moduleOf( reinterpret_cast<const void*>( retired->deleter ) ) == module )
+        {
+            retired->deleter( retired->singleton );
+            delete retired;
+            retiredCount.fetch_sub( 1, std::memory_order_relaxed );
+            ++count;
+            continue;
+        }
+        std::lock_guard<std::mutex> guard( retiredLock );
+        retired->next= retiredSingletons;
+        retiredSingletons= retired;
+    }
+
+    // destructors might create new singletons, which are deleted with the next round
+    for(;;)
+    {
+        // collect the singletons and caches. Code entities are detected without holding the lock.
+        std::vector<TeardownEntry>          entries;
+        std::vector<std::atomic<void*>*>    caches;
+        {
+            std::lock_guard<std::mutex> guard( singletonLock );
+            RegistryTable* table= singletonTable.load( std::memory_order_relaxed );
+            if( table == nullptr )
+                return count;
+            for( std::size_t idx= 0 ; idx <= table->mask ; ++idx )
+            {
+                RegistryEntry& entry= table->entries[idx];
+                void* singleton= entry.singleton.load( std::memory_order_relaxed );
+                if( singleton != nullptr )
+                    entries.push_back( TeardownEntry{ entry.type.load( std::memory_order_relaxed ),
+                                                      singleton, entry.sequence, entry.deleter } );
+                for( CacheSlot* slot= entry.caches ; slot != nullptr ; slot= slot->next )
+                    caches.push_back( slot->cache );
+            }
+        }
+
+        // the code of a singleton is located where its deleter is
+        entries.erase( std::remove_if( entries.begin(), entries.end(),
+                                       [module]( const TeardownEntry& entry )
+                                       {
+                                           return moduleOf( reinterpret_cast<const void*>( entry.deleter ) )
+                                                  != module;
+                                       } ),
+                       entries.end() );
+        caches.erase( std::remove_if( caches.begin(), caches.end(),
+                                      [module]( std::atomic<void*>* cache )
+                                      {
+                                          return moduleOf( cache ) != module;
+                                      } ),
+                      caches.end() );
+
+        // remove the singletons from the registry, which resets the caches of other code entities
+        {
+            std::lock_guard<std::mutex> guard( singletonLock );
+            forgetCaches( caches );
+            auto removed= entries.begin();
+            for( const TeardownEntry& teardownEntry : entries )
+            {
+                RegistryEntry& entry= singletonTable.load( std::memory_order_relaxed )
+                                                    ->Find( *teardownEntry.type );
+                // deleted by another thread in the meantime
+                if( entry.singleton.load( std::memory_order_relaxed ) != teardownEntry.singleton )
+                    continue;
+
+                entry.singleton.store( nullptr, std::memory_order_release );
+                resetCaches( entry );
+                #if ALIB_FEAT_SINGLETON_STATISTICS
+                    entry.statistics->singleton= nullptr;
+                #endif
+                *removed++= teardownEntry;
+            }
+            entries.erase( removed, entries.end() );
+            singletonGeneration.fetch_add( 1, std::memory_order_release );
+        }
+
+        if( entries.empty() )
+            return count;
+
+        // singletons are not registered anymore, hence destructors do not modify the registry
+        std::sort( entries.begin(), entries.end(),
+                   []( const TeardownEntry& lhs, const TeardownEntry& rhs )
+                   {
+                       return lhs.sequence > rhs.sequence;
+                   } );
+        for( const TeardownEntry& entry : entries )
+            entry.deleter( entry.singleton );
+        count+= entries.size();
+    }
 }
+#endif
 
 //! @endcond
 
 
 
 #if ALIB_FEAT_SINGLETON_MAPPED
-    TypeMap<void*> DbgGetSingletons()
+void visitSingletons( void (*visitor)( const TypeKey&, void*, void* ), void* data )
+{
+    // retired tables are freed only with DeleteSingletons, hence the table stays valid
+    RegistryTable* table= singletonTable.load( std::memory_order_acquire );
+    if( table == nullptr )
+        return;
+
+    for( std::size_t idx= 0 ; idx <= table->mask ; ++idx )
+    {
+        RegistryEntry& entry    = table->entries[idx];
+        const TypeKey* type     = entry.type.load( std::memory_order_acquire );
+        void*          singleton= entry.singleton.load( std::memory_order_acquire );
+        if( type != nullptr && singleton != nullptr )
+            visitor( *type, singleton, data );
+    }
+}
+#endif
+
+#if ALIB_FEAT_SINGLETON_MAPPED
+void visitSingletonCreations( void (*visitor)( const TypeKey&, std::size_t, std::thread::id, void* ),
+                              void* data )
+{
+    std::lock_guard<std::mutex> guard( singletonLock );
+    RegistryTable* table= singletonTable.load( std::memory_order_relaxed );
+    if( table == nullptr )
+        return;
+
+    for( std::size_t idx= 0 ; idx <= table->mask ; ++idx )
+    {
+        RegistryEntry& entry= table->entries[idx];
+        if( entry.singleton.load( std::memory_order_relaxed ) != nullptr )
+            visitor( *entry.type.load( std::memory_order_relaxed ), entry.sequence, entry.creator,
+                     data );
+    }
+}
+#endif
+
+#if ALIB_FEAT_SINGLETON_STATISTICS
+void visitSingletonStatistics( void (*visitor)( const SingletonStatistics&, void* ), void* data )
+{
+    // records are freed only with DeleteSingletons
+    for( StatisticsRecord* record= statisticsRecords.load( std::memory_order_acquire ) ;
+         record != nullptr ;
+         record= record->next )
+    {
+        SingletonStatistics statistics;
+        {
+            std::lock_guard<std::mutex> guard( singletonLock );
+            statistics.Type            = record->type;
+            statistics.Instance        = record->singleton;
+            statistics.Sequence        = record->sequence;
+            statistics.Creations       = record->creations;
+            statistics.Creator         = record->creator;
+            statistics.Created         = record->created;
+            statistics.ConstructionTime= record->constructionTime;
+            statistics.Lookups         = record->lookups.load( std::memory_order_relaxed );
+            statistics.LockWaitTime    = record->lockWaitTime;
+        }
+        visitor( statistics, data );
+    }
+}
+
+SingletonLockStatistics GetSingletonLockStatistics()
+{
+    std::lock_guard<std::mutex> guard( singletonLock );
+    return lockStatistics;
+}
+#endif
+
+#if ALIB_FEAT_SINGLETON_MAPPED && ALIB_DEBUG
+    TypeKeyMap<void*> DbgGetSingletons()
     {
-        return singletonMap;
+        TypeKeyMap<void*> result;
+        std::lock_guard<std::mutex> guard( singletonLock );
+        RegistryTable* table= singletonTable.load( std::memory_order_relaxed );
+        if( table != nullptr )
+            for( std::size_t idx= 0 ; idx <= table->mask ; ++idx )
+            {
+                void* singleton= table->entries[idx].singleton.load( std::memory_order_relaxed );
+                if( singleton != nullptr )
+                    result.emplace( *table->entries[idx].type.load( std::memory_order_relaxed ),
+                                    singleton );
+            }
+        return result;
     }
 #endif
 
@@ -17,6 +17,38 @@
 #   include <vector>
 #endif
 
+#if !defined (_GLIBCXX_ATOMIC) && !defined(_ATOMIC_)
+#   include <atomic>
+#endif
+
+#if !defined(HPP_ALIB_SINGLETONS_ALLOCATION)
+#   include "alib/singletons/allocation.hpp"
+#endif
+
+#if !ALIB_FEAT_SINGLETON_MAPPED && !defined (_GLIBCXX_MUTEX) && !defined(_MUTEX_)
+#   include <mutex>
+#endif
+
+
+#if !defined (_GLIBCXX_TYPE_TRAITS) && !defined(_TYPE_TRAITS_)
+#   include <type_traits>
+#endif
+
+#if !defined (_GLIBCXX_UTILITY) && !defined(_UTILITY_)
+#   include <utility>
+#endif
+
+#if !defined (_GLIBCXX_MEMORY) && !defined(_MEMORY_)
+#   include <memory>
+#endif
+
+#if !defined (_GLIBCXX_TUPLE) && !defined(_TUPLE_)
+#   include <tuple>
+#endif
+
+#if ALIB_FEAT_SINGLETON_MAPPED && !defined(HPP_ALIB_LIB_TYPEKEY)
+#   include "alib/lib/typekey.hpp"
+#endif
 
 #if ALIB_FEAT_SINGLETON_MAPPED && ALIB_DEBUG  && !defined(HPP_ALIB_LIB_TYPEMAP)
 #   include "alib/lib/typemap.hpp"
@@ -25,15 +57,159 @@
 namespace aworx { namespace lib { namespace singletons {
 
 // #################################################################################################
-// Unordered map utility for storing type_info objects
+// Registry of singletons, keyed by TypeKey
 // #################################################################################################
 
 //! @cond NO_DOX
+/**
+ * Runs \p{task} on a new thread. The threads are joined with #DeleteSingletons.
+ * @param task  The task.
+ * @param data  The argument passed to \p{task}.
+ */
+extern ALIB_API void  startBackgroundConstruction( void (*task)( void* ), void* data );
+
+/**
+ * Defers the deletion of a replaced singleton, until no thread is in a read section that
+ * started before the replacement.
+ * @param theSingleton  The replaced singleton.
+ * @param deleter       Destructs and frees \p{theSingleton}.
+ */
+extern ALIB_API void  retireSingleton( void* theSingleton, void (*deleter)( void* ) );
+
+/** Starts a (nested) read section of the current thread. Used by \alib{singletons,SingletonReadGuard}. */
+extern ALIB_API void  enterSingletonReadSection();
+
+/** Ends a (nested) read section of the current thread. Used by \alib{singletons,SingletonReadGuard}. */
+extern ALIB_API void  leaveSingletonReadSection();
+
+/**
+ * Incremented whenever a singleton is removed from the registry or replaced, and with
+ * #DeleteSingletons. Used to invalidate resolved pointers cached outside of the registry.
+ */
+extern ALIB_API std::atomic<std::size_t>  singletonGeneration;
+
 #if ALIB_FEAT_SINGLETON_MAPPED
-extern ALIB_API bool  getSingleton   ( const std::type_info& type, void* theSingleton );
-extern ALIB_API void  storeSingleton ( const std::type_info& type, void* theSingleton );
-extern ALIB_API void  removeSingleton( const std::type_info& type );
+/**
+ * Receives a singleton from the registry, or, if it does not exist, makes the caller the
+ * constructing thread.
+ * @param type          The singleton's type.
+ * @param theSingleton  Receives the singleton.
+ * @param cache         \c nullptr or the pointer that caches the singleton in the calling code
+ *                      entity. It is set while the registry lock is held and reset to
+ *                      \c nullptr when the singleton is removed.
+ * @param toCached      Converts the singleton to the value stored in \p{cache}. Used only if
+ *                      \p{cache} is given.
+ * @return \c true if the singleton was received, \c false if the caller has to construct and
+ *         store it.
+ */
+extern ALIB_API bool  getSingleton   ( const TypeKey& type, void* theSingleton,
+                                       std::atomic<void*>* cache= nullptr,
+                                       void* (*toCached)( void* )= nullptr );
+
+/**
+ * Stores a singleton constructed after #getSingleton returned \c false.
+ * @param type          The singleton's type.
+ * @param theSingleton  The singleton.
+ * @param deleter       Destructs and frees the singleton.
+ * @param cache         \c nullptr or the pointer that caches the singleton in the calling code
+ *                      entity. It is set while the registry lock is held.
+ * @param cached        The singleton, as stored in \p{cache}.
+ */
+extern ALIB_API void  storeSingleton ( const TypeKey& type, void* theSingleton,
+                                       void (*deleter)( void* ),
+                                       std::atomic<void*>* cache= nullptr,
+                                       void* cached= nullptr );
+
+/**
+ * Receives existing singletons from the registry. In contrast to #getSingleton, the registry
+ * lock is acquired at most once, to set and add \p{caches}, and singletons that do not exist
+ * are not constructed.
+ * @param count         The number of singletons.
+ * @param types         The singletons' types.
+ * @param singletons    Receives the singletons, \c nullptr for those that do not exist.
+ * @param caches        \c nullptr or the pointer that caches the singleton in the calling code
+ *                      entity, per singleton.
+ * @param toCached      Converts the singleton to the value stored in the cache, per singleton.
+ * @return The number of singletons received.
+ */
+extern ALIB_API std::size_t  getSingletons( std::size_t count, const TypeKey* const* types,
+                                            void** singletons,
+                                            std::atomic<void*>* const* caches,
+                                            void* (* const* toCached)( void* ) );
+extern ALIB_API void  abortSingleton ( const TypeKey& type );
+extern ALIB_API void  removeSingleton( const TypeKey& type, void* theSingleton );
+
+/**
+ * Replaces an existing singleton in the registry and in the caches of all code entities.
+ * @param type          The singleton's type.
+ * @param theSingleton  The new singleton, as stored in the registry.
+ * @param cached        The new singleton, as stored in the caches of code entities.
+ * @param deleter       Destructs and frees the new singleton.
+ * @param oldDeleter    Receives the deleter of the replaced singleton.
+ * @return The replaced singleton, \c nullptr if the singleton does not exist.
+ */
+extern ALIB_API void* replaceSingleton( const TypeKey& type, void* theSingleton, void* cached,
+                                        void (*deleter)( void* ), void (**oldDeleter)( void* ) );
+
+/**
+ * Ends the construction of a singleton with #abortSingleton, unless dismissed. This releases
+ * threads waiting for the singleton, in case its constructor throws.
+ */
+struct SingletonConstruction
+{
+    const TypeKey&   type;       ///< The type of the singleton under construction.
+    bool             dismissed;  ///< Set when the singleton was stored.
+
+    /**
+     * Constructor.
+     * @param pType The type of the singleton under construction.
+     */
+    SingletonConstruction( const TypeKey& pType )
+    : type     ( pType )
+    , dismissed( false )
+    {}
+
+    /** Destructor. Aborts the construction, if not dismissed. */
+    ~SingletonConstruction()
+    {
+        if( !dismissed )
+            abortSingleton( type );
+    }
+};
 #endif
+
+template<typename... TSingletons>
+std::tuple<TSingletons&...>  GetSingletons();
+
+/**
+ * The base class of \alib{singletons,Singleton}, which makes it polymorphic, if \p{TVirtual}
+ * is \c true. Otherwise, its destructor is trivial, hence \p{TDerivedClass} may be trivially
+ * destructible.
+ * @tparam TDerivedClass The class that implements the singleton.
+ * @tparam TVirtual      Denotes if the destructor is virtual.
+ */
+template <typename TDerivedClass, bool TVirtual>
+class SingletonDestructor
+{};
+
+/** Specialization for polymorphic singletons. */
+template <typename TDerivedClass>
+class SingletonDestructor<TDerivedClass, true>
+{
+    public:
+        /**
+         * Virtual destructor. With mapped mode, removes the singleton from the registry, in case
+         * it is deleted by other means than the registry's deleter.
+         */
+        virtual ~SingletonDestructor()
+        {
+            // the registry stores a pointer to Singleton, whose only base is this class and which
+            // has no fields. (A downcast is not allowed here, as Singleton is destructed already.)
+            #if ALIB_FEAT_SINGLETON_MAPPED
+                removeSingleton( TypeKey::Of<TDerivedClass>(), this );
+            #endif
+        }
+};
 //! @endcond
 
 /** ************************************************************************************************
@@ -45,15 +221,151 @@ extern ALIB_API void  removeSingleton( const std::type_info& type );
  * All details about implementation and usage of this class is provided in the module's
  * \ref alib_mod_singletons "Programmer's Manual".
  *
+ * Method #GetSingleton is thread-safe. Once the singleton exists, it costs a single load with
+ * acquire semantics. Under contention, exactly one thread invokes the constructor of
+ * \p{TDerivedClass}, while other threads wait until the instance is available.
+ * With mapped mode, no lock is held while a singleton is constructed: threads wait only for the
+ * singleton they requested, while different singletons are constructed in parallel.
+ * Constructors that (directly or through other threads) wait for their own singleton are
+ * detected and abort the process, instead of deadlocking.
+ *
+ * With mapped mode, compiler symbol \ref ALIB_FEAT_SINGLETON_THREAD_CACHE_ON enables a
+ * thread-local cache of the resolved singleton, which replaces the per-code-entity pointer.
+ * An access then costs one access to thread-local storage plus one load of a global
+ * generation counter, which is incremented with each removal of a singleton (e.g. by
+ * #DeleteSingletons). Hence, after singletons were deleted and re-created, each thread
+ * resolves them once more through the registry, instead of using dangling pointers.
+ * Note that thread-local storage is cheap in executables, but usually involves a call to
+ * \c __tls_get_addr in shared libraries.
+ *
+ * With mapped mode, each code entity that does not share symbols with the others (e.g. a
+ * Windows DLL, or a shared library loaded with \c RTLD_LOCAL or compiled with hidden
+ * visibility) receives the singleton once from the registry and then caches it. The registry
+ * resets these caches when the singleton is removed. Before such a shared library is unloaded,
+ * \alib{singletons,DeleteModuleSingletons} has to be invoked.
+ *
+ * With mapped mode, the registry stores pointers to this base class. These are converted to
+ * \p{TDerivedClass} with \c static_cast, which is why run-time type information is not needed
+ * and \p{TDerivedClass} must not derive virtually from this class.
+ *
+ * Methods #Prewarm and #GetSingletonAsync construct a singleton on a background thread, for
+ * example to construct expensive singletons during the startup of a process in parallel with
+ * other work. They take part in the same creation protocol as #GetSingleton: if a
+ * thread requests a singleton that is constructed in the background, it waits for that
+ * construction, instead of constructing a second instance.
+ *
+ * Method #Replace exchanges the singleton at run-time. Threads that might use the singleton
+ * while it is replaced protect it from being deleted with a \alib{singletons,SingletonReadGuard}.
+ *
+ * Function \alib{singletons,GetSingletons} receives several singletons at once.
+ *
+ * The memory of the singleton is allocated with the policy selected by type trait
+ * \alib{singletons,T_SingletonAllocation}, which defaults to the heap. Singletons that can be
+ * initialized at compile-time are placed in static storage instead, as selected by type trait
+ * \alib{singletons,T_SingletonStaticStorage}. This is done by default for trivial types that
+ * use the heap.
+ *
+ * By default, the destructor of this class is virtual. The registry does not need this, because
+ * it stores a deleter function with each singleton. Hence, with template parameter
+ * \p{TVirtual} set to \c false (or using type alias \alib{singletons,PlainSingleton}), the
+ * singleton has no virtual function table and this class has a trivial destructor. Then,
+ * \p{TDerivedClass} may be a standard-layout or trivial type and is not enlarged by a pointer.
+ * However, a singleton must then be deleted only by the library: it is neither deleted through
+ * a pointer to this class, nor removed from the registry by its destructor.
+ *
  * @tparam TDerivedClass Template parameter that denotes the name of the class that implements
  *                       the singleton.
+ * @tparam TVirtual      Denotes if the destructor of this class is virtual. Defaults to \c true.
  **************************************************************************************************/
-template <typename TDerivedClass>
-class Singleton
+template <typename TDerivedClass, bool TVirtual= true>
+class Singleton : public SingletonDestructor<TDerivedClass, TVirtual>
 {
     protected:
-        /** A pointer to the one and only singleton. */
-        static TDerivedClass*  singleton;
+        /**
+         * A pointer to the one and only singleton, given as a pointer to \p{TDerivedClass}.
+         * The pointer is written with release and read with acquire semantics, hence a thread
+         * that receives it also sees the fully constructed object.
+         *
+         * Each code entity (executable or shared library) that does not share symbols with the
+         * others has its own copy of this pointer. With mapped mode, the registry resets all
+         * copies when the singleton is removed.
+         */
+        static std::atomic<void*>           singleton;
+
+        /**
+         * Denotes if \p{TDerivedClass} is placed in #StaticStorage. (A nested type, because
+         * \p{TDerivedClass} is incomplete when this class is instantiated.)
+         */
+        struct IsStatic
+        : std::integral_constant<bool, T_SingletonStaticStorage<TDerivedClass>::value>
+        {};
+
+        /**
+         * Denotes if #singleton is initialized with the singleton in #StaticStorage and hence is
+         * never \c nullptr. This is not done with mapped mode, where the singleton is received
+         * from the registry.
+         */
+        struct IsPreset
+        : std::integral_constant<bool, IsStatic::value && !ALIB_FEAT_SINGLETON_MAPPED>
+        {};
+
+        /**
+         * The static storage of singletons selected with
+         * \alib{singletons,T_SingletonStaticStorage}. (A template, because \p{TDerivedClass} is
+         * incomplete when this class is instantiated. Only the specialization for
+         * \p{TDerivedClass} is used.)
+         * @tparam T The singleton type.
+         */
+        template<typename T>
+        struct StaticStorage
+        {
+            /** Holds the singleton without destructing it. */
+            union Storage
+            {
+                T           instance;   ///< The singleton.
+
+                /**
+                 * Constructor. Value-initializes #instance, which is done at compile-time, if
+                 * the default constructor of \p{T} is \c constexpr or trivial.
+                 */
+                constexpr Storage()
+                : instance()
+                {}
+
+                /** Destructor. Does not destruct #instance. */
+                ~Storage()
+                {}
+            };
+
+            /** The singleton. Defined only if this type is used. */
+            static Storage  storage;
+        };
+
+    #if ALIB_FEAT_SINGLETON_THREAD_CACHE
+        /** The thread-local cache of the singleton. */
+        struct ThreadCache
+        {
+            TDerivedClass*  singleton;  ///< The singleton resolved by this thread.
+            std::size_t     generation; ///< The \c singletonGeneration the singleton was resolved in.
+        };
+
+        /**
+         * The singleton as resolved by the current thread. Valid only as long as the global
+         * generation counter is not changed by the removal of any singleton.
+         */
+        static thread_local ThreadCache     threadCache;
+    #endif
+
+    #if !ALIB_FEAT_SINGLETON_MAPPED
+        /**
+         * Per-type once-guard, acquired only by #createSingleton and #Replace.
+         * (With mapped mode, the singleton map tracks singletons under construction per type.)
+         */
+        static std::mutex                   creationLock;
+
+        /** Denotes if the singleton was set with #Replace. Modified only with #creationLock. */
+        static bool                         replaced;
+    #endif
 
     public:
         /**
@@ -62,41 +374,570 @@ class Singleton
          */
         inline static TDerivedClass&    GetSingleton()
         {
-            if( !singleton )
+            TDerivedClass* result= peekSingleton();
+            if( IsPreset::value || result != nullptr )
+                return *result;
+
+            return *createSingleton();
+        }
+
+        /**
+         * Starts the construction of the singleton on a background thread, unless the singleton
+         * exists already. This method returns immediately.
+         *
+         * The constructor of \p{TDerivedClass} must not throw when invoked in the background.
+         * Background threads are joined with \alib{singletons,DeleteSingletons}.
+         */
+        static void                     Prewarm()
+        {
+            if( peekSingleton() != nullptr )
+                return;
+
+            startBackgroundConstruction( []( void* ) { GetSingleton(); }, nullptr );
+        }
+
+        /**
+         * Invokes \p{callback} with the singleton. If the singleton exists, \p{callback} is
+         * invoked immediately by the calling thread. Otherwise, the singleton is constructed
+         * (or, if this is done by another thread already, awaited) on a background thread,
+         * which then invokes \p{callback}. In both cases, this method does not block.
+         *
+         * The same restrictions as documented with #Prewarm apply. In addition, exceptions
+         * thrown by \p{callback} on the background thread terminate the process.
+         *
+         * @param callback A callable that accepts a reference to \p{TDerivedClass}. It is moved
+         *                 (or copied) if invoked in the background.
+         * @tparam TCallback The type of \p{callback}.
+         */
+        template<typename TCallback>
+        static void                     GetSingletonAsync( TCallback&& callback )
+        {
+            TDerivedClass* result= peekSingleton();
+            if( result != nullptr )
             {
-                #if ALIB_FEAT_SINGLETON_MAPPED
-                    Singleton<TDerivedClass>* castedAsSingleton;
-                    if( !getSingleton(typeid(TDerivedClass), &castedAsSingleton ) )
-                    {
-                        singleton= new TDerivedClass();
-                        castedAsSingleton= dynamic_cast<Singleton<TDerivedClass>*>( singleton );
+                callback( *result );
+                return;
+            }
 
-                        storeSingleton( typeid(TDerivedClass), castedAsSingleton );
+            using TStored= typename std::decay<TCallback>::type;
+            startBackgroundConstruction( []( void* data )
+                                         {
+                                             TStored* stored= static_cast<TStored*>( data );
+                                             (*stored)( GetSingleton() );
+                                             delete stored;
+                                         },
+                                         new TStored( std::forward<TCallback>( callback ) ) );
+        }
+
+        /**
+         * Replaces the singleton with \p{replacement}, for example to rebuild a configuration at
+         * run-time. If the singleton does not exist, yet, \p{replacement} becomes the singleton.
+         *
+         * Each thread receives either the old or the new singleton. #GetSingleton continues to
+         * cost a single load with acquire semantics. With mapped mode, the registry and the
+         * pointers of all code entities are updated while the registry lock is held.
+         *
+         * The old singleton is not deleted immediately, as other threads might still use it.
+         * Threads that use a replaceable singleton have to do this within the scope of a
+         * \alib{singletons,SingletonReadGuard}. The old singleton is deleted (epoch-based) once
+         * all guards that existed at the time of replacement are destructed, which is detected
+         * with the destruction of guards and with further replacements.
+         * \alib{singletons,DeleteSingletons} deletes all replaced singletons.
+         *
+         * @param replacement The new singleton. It is deleted with \c delete, regardless of the
+         *                    allocation policy of \p{TDerivedClass}.
+         */
+        static void                     Replace( std::unique_ptr<TDerivedClass> replacement )
+        {
+            TDerivedClass*  instance= replacement.release();
+
+            #if ALIB_FEAT_SINGLETON_MAPPED
+                Singleton*  castedAsSingleton= instance;
+                #if ALIB_FEAT_SINGLETON_THREAD_CACHE
+                    // the generation counter invalidates the thread caches
+                    std::atomic<void*>* cache= nullptr;
+                #else
+                    std::atomic<void*>* cache= &singleton;
+                #endif
+
+                for(;;)
+                {
+                    void (*oldDeleter)( void* );
+                    void* old= replaceSingleton( TypeKey::Of<TDerivedClass>(), castedAsSingleton,
+                                                 instance, &deleteReplacement, &oldDeleter );
+                    if( old != nullptr )
+                    {
+                        retireSingleton( old, oldDeleter );
+                        return;
                     }
-                    else
+
+                    // not existing: the replacement becomes the singleton, unless another thread
+                    // created it in the meantime
+                    Singleton* existing;
+                    if( !getSingleton( TypeKey::Of<TDerivedClass>(), &existing, cache, &toCached ) )
                     {
-                        singleton= dynamic_cast<TDerivedClass*>( castedAsSingleton );
+                        SingletonConstruction construction( TypeKey::Of<TDerivedClass>() );
+                        storeSingleton( TypeKey::Of<TDerivedClass>(), castedAsSingleton,
+                                        &deleteReplacement, cache, instance );
+                        construction.dismissed= true;
+                        return;
                     }
-                #else
-                    singleton= new TDerivedClass();
-                #endif
-            }
-            return *singleton;
+                }
+            #else
+                std::lock_guard<std::mutex> guard( creationLock );
+                TDerivedClass* old= static_cast<TDerivedClass*>(
+                                    singleton.exchange( instance, std::memory_order_acq_rel ) );
+                if( old != nullptr )
+                    retireSingleton( static_cast<Singleton*>( old ),
+                                     replaced ? &deleteReplacement : &destruct );
+                replaced= true;
+                singletonGeneration.fetch_add( 1, std::memory_order_release );
+            #endif
+        }
+
+    protected:
+        template<typename... TSingletons>
+        friend std::tuple<TSingletons&...>  GetSingletons();
+
+        /**
+         * Returns the pointer that is registered to cache the singleton in this code entity.
+         * @return \c nullptr with the thread-local cache, #singleton otherwise.
+         */
+        static std::atomic<void*>*      registeredCache()
+        {
+            #if ALIB_FEAT_SINGLETON_THREAD_CACHE
+                // the generation counter invalidates the thread caches
+                return nullptr;
+            #else
+                return &singleton;
+            #endif
+        }
+
+        /**
+         * Converts a singleton received from the registry to the value stored in #singleton.
+         * @param theSingleton  The singleton, given as a pointer to this base class.
+         * @return The singleton, given as a pointer to \p{TDerivedClass}.
+         */
+        static void*                    toCached( void* theSingleton )
+        {
+            // a constant pointer adjustment, as TDerivedClass derives from this class
+            return static_cast<TDerivedClass*>( static_cast<Singleton*>( theSingleton ) );
         }
 
-        /** Virtual destructor. */
-        virtual  ~Singleton()
+        /**
+         * Caches a singleton received from the registry with
+         * \alib{singletons,getSingletons} in the thread-local cache. (#singleton is set by the
+         * registry, while its lock is held.)
+         * @param theSingleton  The singleton, given as a pointer to this base class, or
+         *                      \c nullptr if it does not exist.
+         * @param generation    The \c singletonGeneration read before the singleton was received.
+         */
+        static void                     cacheSingleton( void* theSingleton, std::size_t generation )
         {
+            #if ALIB_FEAT_SINGLETON_THREAD_CACHE
+                if( theSingleton == nullptr )
+                    return;
+
+                threadCache.singleton = static_cast<TDerivedClass*>( toCached( theSingleton ) );
+                threadCache.generation= generation;
+            #else
+                (void) theSingleton;
+                (void) generation;
+            #endif
+        }
+
+        /**
+         * Returns the initial value of #singleton.
+         * @return The singleton in #StaticStorage.
+         */
+        static constexpr void*          presetSingleton( std::true_type )
+        {
+            return &StaticStorage<TDerivedClass>::storage.instance;
+        }
+
+        /**
+         * Returns the initial value of #singleton, if #StaticStorage is not used.
+         * @return \c nullptr.
+         */
+        static constexpr void*          presetSingleton( std::false_type )
+        {
+            return nullptr;
+        }
+
+        /**
+         * The fast path of #GetSingleton.
+         * @return The singleton instance, \c nullptr if not created or not received, yet.
+         */
+        inline static TDerivedClass*    peekSingleton()
+        {
+            #if ALIB_FEAT_SINGLETON_THREAD_CACHE
+                ThreadCache& cache= threadCache;
+                if( cache.generation == singletonGeneration.load( std::memory_order_acquire ) )
+                    return cache.singleton;
+                return nullptr;
+            #else
+                return static_cast<TDerivedClass*>( singleton.load( std::memory_order_acquire ) );
+            #endif
+        }
+
+        /**
+         * The slow path of #GetSingleton. Creates the singleton, or, in case another thread
+         * or code entity did this already, receives it.
+         * @return The singleton instance.
+         */
+        static TDerivedClass*           createSingleton()
+        {
+            TDerivedClass* result;
+
+            #if ALIB_FEAT_SINGLETON_THREAD_CACHE
+                // read before the lookup: a removal in between invalidates the cache again
+                std::size_t generation= singletonGeneration.load( std::memory_order_acquire );
+
+                // the generation counter invalidates the thread caches
+                std::atomic<void*>* cache= nullptr;
+            #elif ALIB_FEAT_SINGLETON_MAPPED
+                std::atomic<void*>* cache= &singleton;
+            #endif
+
             #if ALIB_FEAT_SINGLETON_MAPPED
-                removeSingleton( typeid(TDerivedClass) );
+                Singleton* castedAsSingleton;
+                // #singleton is set by the registry while its lock is held. Setting it here
+                // could overwrite a singleton replaced or removed in the meantime.
+                if( !getSingleton( TypeKey::Of<TDerivedClass>(), &castedAsSingleton, cache,
+                                   &toCached ) )
+                {
+                    SingletonConstruction construction( TypeKey::Of<TDerivedClass>() );
+                    result= construct();
+                    castedAsSingleton= result;
+
+                    storeSingleton( TypeKey::Of<TDerivedClass>(), castedAsSingleton, &destruct,
+                                    cache, result );
+                    construction.dismissed= true;
+                }
+                else
+                    result= static_cast<TDerivedClass*>( toCached( castedAsSingleton ) );
+            #else
+                std::lock_guard<std::mutex> guard( creationLock );
+                result= static_cast<TDerivedClass*>( singleton.load( std::memory_order_relaxed ) );
+                if( result != nullptr )
+                    return result;
+
+                result= construct();
+                singleton.store( result, std::memory_order_release );
             #endif
+
+            #if ALIB_FEAT_SINGLETON_THREAD_CACHE
+                threadCache.singleton = result;
+                threadCache.generation= generation;
+            #endif
+
+            return result;
+        }
+
+        /**
+         * Allocates the singleton with the allocation policy of \p{TDerivedClass} and invokes
+         * its constructor, or returns the singleton in #StaticStorage.
+         * @return The singleton instance.
+         */
+        static TDerivedClass*           construct()
+        {
+            return construct( IsStatic() );
+        }
+
+        /**
+         * Returns the singleton in #StaticStorage.
+         * @return The singleton instance.
+         */
+        static TDerivedClass*           construct( std::true_type )
+        {
+            return &StaticStorage<TDerivedClass>::storage.instance;
+        }
+
+        /**
+         * Implementation of #construct for singletons that are allocated.
+         * @return The singleton instance.
+         */
+        static TDerivedClass*           construct( std::false_type )
+        {
+            // frees the memory, if the constructor throws
+            struct Memory
+            {
+                void*   memory;     ///< The allocated memory. Set to \c nullptr when constructed.
+
+                /** Destructor. Frees #memory. */
+                ~Memory()
+                {
+                    if( memory != nullptr )
+                        T_SingletonAllocation<TDerivedClass>::Free( memory, sizeof(TDerivedClass),
+                                                                    alignof(TDerivedClass) );
+                }
+            };
+
+            Memory memory= { T_SingletonAllocation<TDerivedClass>::Allocate( sizeof(TDerivedClass),
+                                                                             alignof(TDerivedClass) ) };
+            TDerivedClass* result= new ( memory.memory ) TDerivedClass();
+            memory.memory= nullptr;
+            return result;
+        }
+
+        /**
+         * Destructs and frees a singleton created with #construct. Does nothing if the singleton
+         * is placed in #StaticStorage.
+         * @param theSingleton The singleton, given as a pointer to this base class.
+         */
+        static void                     destruct( void* theSingleton )
+        {
+            // singletons in static storage are never destructed
+            if( IsStatic::value )
+                return;
+
+            TDerivedClass* instance= static_cast<TDerivedClass*>(
+                                     static_cast<Singleton*>( theSingleton ) );
+            instance->~TDerivedClass();
+            T_SingletonAllocation<TDerivedClass>::Free( instance, sizeof(TDerivedClass),
+                                                        alignof(TDerivedClass) );
+        }
+
+        /**
+         * Deletes a singleton set with #Replace.
+         * @param theSingleton The singleton, given as a pointer to this base class.
+         */
+        static void                     deleteReplacement( void* theSingleton )
+        {
+            delete static_cast<TDerivedClass*>( static_cast<Singleton*>( theSingleton ) );
         }
 
 };// class Singleton
 
 // The static singleton instance initialization
+template <typename TDerivedClass, bool TVirtual>
+std::atomic<void*>          Singleton<TDerivedClass, TVirtual>::singleton(
+                                Singleton<TDerivedClass, TVirtual>::presetSingleton(
+                                    typename Singleton<TDerivedClass, TVirtual>::IsPreset() ) );
+
+#if defined(__cpp_constinit)
+template <typename TDerivedClass, bool TVirtual>
+template <typename T>
+constinit typename Singleton<TDerivedClass, TVirtual>::template StaticStorage<T>::Storage
+                            Singleton<TDerivedClass, TVirtual>::StaticStorage<T>::storage;
+#else
+template <typename TDerivedClass, bool TVirtual>
+template <typename T>
+typename Singleton<TDerivedClass, TVirtual>::template StaticStorage<T>::Storage
+                            Singleton<TDerivedClass, TVirtual>::StaticStorage<T>::storage;
+#endif
+
+#if ALIB_FEAT_SINGLETON_THREAD_CACHE
+template <typename TDerivedClass, bool TVirtual>
+thread_local typename Singleton<TDerivedClass, TVirtual>::ThreadCache
+                            Singleton<TDerivedClass, TVirtual>::threadCache= { nullptr, 0 };
+#endif
+
+#if !ALIB_FEAT_SINGLETON_MAPPED
+template <typename TDerivedClass, bool TVirtual>
+std::mutex                  Singleton<TDerivedClass, TVirtual>::creationLock;
+
+template <typename TDerivedClass, bool TVirtual>
+bool                        Singleton<TDerivedClass, TVirtual>::replaced= false;
+#endif
+
+/**
+ * Type alias of a \alib{singletons,Singleton} without virtual destructor.
+ * @tparam TDerivedClass The class that implements the singleton.
+ */
 template <typename TDerivedClass>
-TDerivedClass* Singleton<TDerivedClass>::singleton= nullptr;
+using PlainSingleton=       Singleton<TDerivedClass, false>;
+
+/** ************************************************************************************************
+ * Returns the singletons of types \p{TSingletons}, which are created if they do not exist.
+ * This is a shortcut to invoking \alib{singletons,Singleton::GetSingleton} for each type, for
+ * example in the constructor of a subsystem that uses many singletons:
+ *
+ *      auto   singletons= GetSingletons<Configuration, Logger, Clock>();
+ *      Logger& logger    = std::get<1>( singletons );
+ *
+ * With mapped mode, the singletons that are not cached in the calling code entity, yet, are
+ * received from the registry in one pass, which acquires the registry lock at most once,
+ * instead of once per singleton. Singletons that do not exist are then created one after the
+ * other, in the order of \p{TSingletons}, with the same protocol as
+ * \alib{singletons,Singleton::GetSingleton}. (They are not reserved in advance, because their
+ * constructors might request each other.)
+ *
+ * Without mapped mode, no registry exists and this function just invokes
+ * \alib{singletons,Singleton::GetSingleton} for each type.
+ *
+ * @tparam TSingletons The singleton types.
+ * @return A tuple of references to the singletons.
+ **************************************************************************************************/
+template<typename... TSingletons>
+std::tuple<TSingletons&...>  GetSingletons()
+{
+    static_assert( sizeof...(TSingletons) > 0, "GetSingletons needs at least one type" );
+
+    #if ALIB_FEAT_SINGLETON_MAPPED
+        constexpr std::size_t count= sizeof...(TSingletons);
+        using     Converter= void* (*)( void* );
+
+        // read before the lookup: a removal in between invalidates the thread caches again
+        std::size_t generation= singletonGeneration.load( std::memory_order_acquire );
+
+        const bool                 cached[count]= { ( TSingletons::peekSingleton() != nullptr )... };
+        const TypeKey*      const  allTypes [count]= { &TypeKey::Of<TSingletons>()... };
+        std::atomic<void*>* const  allCaches[count]= { TSingletons::registeredCache()... };
+        const Converter            allConverters[count]= { &TSingletons::toCached... };
+
+        // receive those that are not cached
+        const TypeKey*      types [count];
+        std::atomic<void*>* caches[count];
+        Converter           converters[count];
+        void*               received[count];
+        std::size_t         missing= 0;
+        for( std::size_t idx= 0 ; idx < count ; ++idx )
+            if( !cached[idx] )
+            {
+                types     [missing]= allTypes     [idx];
+                caches    [missing]= allCaches    [idx];
+                converters[missing]= allConverters[idx];
+                ++missing;
+            }
+
+        if( missing != 0 )
+        {
+            getSingletons( missing, types, received, caches, converters );
+
+            void* all[count];
+            for( std::size_t idx= 0, next= 0 ; idx < count ; ++idx )
+                all[idx]= cached[idx] ? nullptr : received[next++];
+
+            // a braced list is evaluated from left to right
+            std::size_t idx= 0;
+            int expansion[count]= { ( TSingletons::cacheSingleton( all[idx++], generation ), 0 )... };
+            (void) expansion;
+        }
+    #endif
+
+    // creates those that do not exist, in the given order
+    return std::tuple<TSingletons&...>{ TSingletons::GetSingleton()... };
+}
+
+/** ************************************************************************************************
+ * Caches a singleton for repeated access, for example by a loop or by an object that uses
+ * the singleton frequently. An access costs one load of a global generation counter with
+ * acquire semantics. The singleton is received with \alib{singletons,Singleton::GetSingleton}
+ * with the first access and again after the counter was incremented, which is done when any
+ * singleton is removed (for example by \alib{singletons,DeleteSingletons}) or replaced with
+ * \alib{singletons,Singleton::Replace}. Hence, a handle remains valid when singletons are
+ * deleted and created again, for example by tests or when a process restarts its subsystems.
+ *
+ * In contrast to \alib{singletons,Singleton::GetSingleton}, with mapped mode, an access does not
+ * depend on the pointer of the code entity, respectively on thread-local storage with
+ * \ref ALIB_FEAT_SINGLETON_THREAD_CACHE_ON. A handle is not thread-safe: each thread has to use
+ * its own handle.
+ *
+ *      SingletonHandle<Metrics> metrics;
+ *      for( const Request& request : requests )
+ *          metrics->Count( request );
+ *
+ * @tparam TSingleton The singleton type, derived from \alib{singletons,Singleton}.
+ **************************************************************************************************/
+template<typename TSingleton>
+class SingletonHandle
+{
+    protected:
+        /** The singleton, \c nullptr if not received, yet. */
+        TSingleton*         singleton;
+
+        /** The value of \c singletonGeneration, read before #singleton was received. */
+        std::size_t         generation;
+
+    public:
+        /** Constructor. The singleton is received with the first access. */
+        SingletonHandle()
+        : singleton ( nullptr )
+        , generation( 0 )
+        {}
+
+        /**
+         * Returns the singleton. Receives it, if this is the first access or if singletons
+         * were removed or replaced since it was received.
+         * @return The singleton.
+         */
+        inline TSingleton&  Get()
+        {
+            std::size_t current= singletonGeneration.load( std::memory_order_acquire );
+            if( current != generation )
+                receive( current );
+            return *singleton;
+        }
+
+        /**
+         * Returns the singleton.
+         * @return The singleton.
+         */
+        TSingleton&         operator*()
+        {
+            return Get();
+        }
+
+        /**
+         * Returns a pointer to the singleton.
+         * @return The singleton.
+         */
+        TSingleton*         operator->()
+        {
+            return &Get();
+        }
+
+    protected:
+        /**
+         * Receives the singleton.
+         * @param current The value of \c singletonGeneration, read before.
+         */
+        void                receive( std::size_t current )
+        {
+            singleton = &TSingleton::GetSingleton();
+            generation= current;
+        }
+};
+
+/** ************************************************************************************************
+ * Defines a read section of the current thread, in which singletons received with
+ * \alib{singletons,Singleton::GetSingleton} are not deleted, even if they are replaced with
+ * \alib{singletons,Singleton::Replace} by another thread. Read sections may be nested.
+ *
+ * Constructing and destructing a guard costs a few atomic operations, while accessing
+ * singletons within the section is not affected. Guards should be short-lived: singletons that
+ * were replaced are deleted only after all guards that existed at the time of replacement are
+ * destructed.
+ *
+ *      {
+ *          SingletonReadGuard guard;
+ *          const Route& route= RoutingTable::GetSingleton().Find( address );
+ *          ...
+ *      }
+ **************************************************************************************************/
+class SingletonReadGuard
+{
+    public:
+        /** Constructor. Starts a read section. */
+        SingletonReadGuard()
+        {
+            enterSingletonReadSection();
+        }
+
+        /** Destructor. Ends the read section. */
+        ~SingletonReadGuard()
+        {
+            leaveSingletonReadSection();
+        }
+
+    private:
+        /** Deleted copy constructor. */
+        SingletonReadGuard( const SingletonReadGuard& )= delete;
+
+        /** Deleted copy assignment. */
+        SingletonReadGuard& operator=( const SingletonReadGuard& )= delete;
+};
 
 
 /** ************************************************************************************************
@@ -110,15 +951,114 @@ TDerivedClass* Singleton<TDerivedClass>::singleton= nullptr;
  * module <b>%ALib %Singleton</b>), then method \aworx{lib,Module::TerminationCleanUp} invokes this
  * method already.
  *
+ * With mapped mode, singletons are deleted in reverse order of their creation. Dependencies
+ * declared with \alib{singletons,RegisterSingleton} are respected in addition: a singleton is
+ * deleted only after the singletons that declared to depend on it.
+ * If \p{threadCount} is greater than \c 1, independent singletons are deleted in parallel.
+ * Here, singletons that are registered are assumed to depend only on their declared
+ * dependencies, while any other singleton is assumed to depend on all singletons created before
+ * it.
+ *
+ * Threads started with \alib{singletons,Singleton::Prewarm} and
+ * \alib{singletons,Singleton::GetSingletonAsync} are joined first. Then, singletons that were
+ * replaced with \alib{singletons,Singleton::Replace} and not deleted, yet, are deleted,
+ * regardless of \alib{singletons,SingletonReadGuard} instances. (This is done with mapped and
+ * unmapped mode.)
+ *
+ * Singletons placed in static storage (see \alib{singletons,T_SingletonStaticStorage}) are
+ * not destructed, but only removed from the registry.
+ *
+ * Singletons are deleted in bulk: the registry is not updated with each deletion, but released
+ * once all singletons are deleted. Then, also the arenas of \alib{singletons,ArenaAllocation}
+ * and \alib{singletons,HugePageArenaAllocation} are released. Hence, destructors must not
+ * request singletons that they do not depend on. Singletons created by destructors are deleted
+ * as well.
+ *
  * \note This method is not thread-safe and hence must be called only on termination of the process
  *       when all threads which are using singletons are terminated.
+ *
+ * @param threadCount The number of threads to use for deletion. If \c 0, the number of hardware
+ *                    threads is used. Defaults to \c 1.
  **************************************************************************************************/
-ALIB_API void  DeleteSingletons();
+ALIB_API void  DeleteSingletons( unsigned int threadCount= 1 );
+
+#if ALIB_FEAT_SINGLETON_MAPPED || ALIB_DOCUMENTATION_PARSER
+/** ************************************************************************************************
+ * Prepares the unloading of a shared library (for example a plugin loaded with \c dlopen) by
+ * deleting the singletons whose code is located in the library and by removing the library's
+ * references to singletons from the registry.
+ *
+ * A singleton's code is located in the library that constructed it. Such singletons have to be
+ * deleted before the library is unloaded, because their destructors and virtual function tables
+ * are unloaded with it. They are deleted in reverse order of their creation. Singletons of the
+ * same types that are requested later are constructed again by the code entity requesting them.
+ * The pointers that cache these singletons in other code entities are reset.
+ *
+ * Singletons constructed by other code entities are not deleted. Instead, the registry forgets
+ * the library's pointers that cache them, which otherwise would be reset when the singletons
+ * are removed after the library was unloaded.
+ *
+ * A library may invoke this function itself, for example when it is notified about its
+ * unloading, or the process that loads the library invokes it before unloading:
+ *
+ *      void* plugin= dlopen( "libplugin.so", RTLD_NOW | RTLD_LOCAL );
+ *      ...
+ *      DeleteModuleSingletons( dlsym( plugin, "PluginMain" ) );
+ *      dlclose( plugin );
+ *
+ * The library is detected with \c dladdr on GNU/Linux and macOS and with
+ * \c GetModuleHandleEx on Windows OS.
+ *
+ * \note
+ *   This method is available only if code selection symbol \ref ALIB_FEAT_SINGLETON_MAPPED
+ *   evaluates to true. Threads must not use singletons of the library while this function
+ *   runs. Threads started with \alib{singletons,Singleton::Prewarm} and
+ *   \alib{singletons,Singleton::GetSingletonAsync} are joined first.
+ *
+ * @param address The address of any function or of any object with static storage duration of
+ *                the library.
+ * @return The number of singletons deleted.
+ **************************************************************************************************/
+ALIB_API std::size_t  DeleteModuleSingletons( const void* address );
+#endif
+
+#if ALIB_FEAT_SINGLETON_MAPPED || ALIB_DOCUMENTATION_PARSER
+
+//! @cond NO_DOX
+extern ALIB_API void visitSingletons( void (*visitor)( const TypeKey&, void*, void* ), void* data );
+//! @endcond
+
+/** ************************************************************************************************
+ * Invokes \p{visitor} with the type and a pointer to each singleton that currently exists.
+ * No memory is allocated and no lock is held while \p{visitor} is invoked. Singletons created
+ * or deleted while visiting might or might not be visited.
+ *
+ * \note
+ *   This method is available only if code selection symbol \ref ALIB_FEAT_SINGLETON_MAPPED
+ *   evaluates to true. Statistics about singletons are provided with
+ *   \alib{singletons,VisitSingletonStatistics}.
+ *
+ * @param visitor A callable that accepts a <c>const TypeKey&</c> and a <c>void*</c>.
+ * @tparam TVisitor The type of \p{visitor}.
+ **************************************************************************************************/
+template<typename TVisitor>
+void VisitSingletons( TVisitor&& visitor )
+{
+    using TPointer= typename std::remove_reference<TVisitor>::type*;
+    TPointer pointer= &visitor;
+    visitSingletons( []( const TypeKey& type, void* singleton, void* data )
+                     {
+                         (**static_cast<TPointer*>( data ))( type, singleton );
+                     },
+                     &pointer );
+}
+
+#endif // ALIB_FEAT_SINGLETON_MAPPED
 
 #if ALIB_FEAT_SINGLETON_MAPPED &&  ALIB_DEBUG
 
     /** ********************************************************************************************
-     * This debug helper function returns a type map with void pointers to all singletons.
+     * This debug helper function returns a type key map with void pointers to all singletons.
      *
      * The function may be used to investiage which singleton objects are created within a
      * process and the point in (run-) time of creation.
@@ -131,18 +1071,33 @@ ALIB_API void  DeleteSingletons();
      *   If the \alibdist includes \alibmod_strings then a simple dumping method is available with
      *   \alib{singletons,DbgGetSingletons(NAString&)}.
      *
+     * \note
+     *   This method copies the registry into a new map. Function \alib{singletons,VisitSingletons}
+     *   does not allocate memory and is available in release compilations as well.
+     *
      * @return The map of singleton types with void pointers to the singletons.
      **********************************************************************************************/
-    ALIB_API  TypeMap<void*>    DbgGetSingletons();
+    ALIB_API  TypeKeyMap<void*> DbgGetSingletons();
 
 #endif // ALIB_FEAT_SINGLETON_MAPPED && ALIB_DEBUG
 
 
 }} // namespace aworx[::lib::singletons]
 
+/// Type alias in namespace #aworx.
+template<typename T, bool TVirtual= true>
+using Singleton=    aworx::lib::singletons::Singleton<T, TVirtual>;
+
+/// Type alias in namespace #aworx.
+template<typename T>
+using PlainSingleton=    aworx::lib::singletons::Singleton<T, false>;
+
+/// Type alias in namespace #aworx.
+using SingletonReadGuard=    aworx::lib::singletons::SingletonReadGuard;
+
 /// Type alias in namespace #aworx.
 template<typename T>
-using Singleton=    aworx::lib::singletons::Singleton<T>;
+using SingletonHandle=    aworx::lib::singletons::SingletonHandle<T>;
 
 } // namespace aworx
 
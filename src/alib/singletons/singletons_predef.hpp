@@ -38,6 +38,36 @@
     #endif
 #endif
 
+#if defined(ALIB_FEAT_SINGLETON_THREAD_CACHE)
+    #error "Code selector symbol ALIB_FEAT_SINGLETON_THREAD_CACHE must not be set from outside. Use postfix '_ON' or '_OFF' for compiler symbols."
+#endif
+
+#if defined(ALIB_FEAT_SINGLETON_THREAD_CACHE_ON) && defined(ALIB_FEAT_SINGLETON_THREAD_CACHE_OFF)
+    #error "Compiler symbols ALIB_FEAT_SINGLETON_THREAD_CACHE_ON and ALIB_FEAT_SINGLETON_THREAD_CACHE_OFF are both set (contradiciton)"
+#endif
+
+// The thread-local cache is available only with mapped mode and defaults to off.
+#if ALIB_FEAT_SINGLETON_MAPPED && defined(ALIB_FEAT_SINGLETON_THREAD_CACHE_ON)
+    #define ALIB_FEAT_SINGLETON_THREAD_CACHE   1
+#else
+    #define ALIB_FEAT_SINGLETON_THREAD_CACHE   0
+#endif
+
+#if defined(ALIB_FEAT_SINGLETON_STATISTICS)
+    #error "Code selector symbol ALIB_FEAT_SINGLETON_STATISTICS must not be set from outside. Use postfix '_ON' or '_OFF' for compiler symbols."
+#endif
+
+#if defined(ALIB_FEAT_SINGLETON_STATISTICS_ON) && defined(ALIB_FEAT_SINGLETON_STATISTICS_OFF)
+    #error "Compiler symbols ALIB_FEAT_SINGLETON_STATISTICS_ON and ALIB_FEAT_SINGLETON_STATISTICS_OFF are both set (contradiciton)"
+#endif
+
+// Statistics are available only with mapped mode and default to off.
+#if ALIB_FEAT_SINGLETON_MAPPED && defined(ALIB_FEAT_SINGLETON_STATISTICS_ON)
+    #define ALIB_FEAT_SINGLETON_STATISTICS   1
+#else
+    #define ALIB_FEAT_SINGLETON_STATISTICS   0
+#endif
+
 
 
 #endif // HPP_ALIB_SINGLETONS_PREDEF
@@ -0,0 +1,140 @@
+// #################################################################################################
+//  ALib C++ Library
+//
+//  Module Singletons
+//
+//  Copyright 2013-2019 A-Worx GmbH, Germany
+//  Published under 'Boost Software License' (a free software license, see LICENSE.txt)
+// #################################################################################################
+#ifndef HPP_ALIB_SINGLETONS_STATISTICS
+#define HPP_ALIB_SINGLETONS_STATISTICS 1
+
+#if !defined (HPP_ALIB_SINGLETONS_SINGLETON)
+#   include "alib/singletons/singleton.hpp"
+#endif
+
+#if ALIB_FEAT_SINGLETON_STATISTICS || ALIB_DOCUMENTATION_PARSER
+
+#if !defined (_GLIBCXX_CHRONO) && !defined(_CHRONO_)
+#   include <chrono>
+#endif
+
+#if !defined (_GLIBCXX_THREAD) && !defined(_THREAD_)
+#   include <thread>
+#endif
+
+#if !defined (_GLIBCXX_TYPE_TRAITS) && !defined(_TYPE_TRAITS_)
+#   include <type_traits>
+#endif
+
+namespace aworx { namespace lib { namespace singletons {
+
+/** ************************************************************************************************
+ * Statistics of a singleton type, as passed to the visitor of
+ * \alib{singletons,VisitSingletonStatistics}.
+ *
+ * Construction and creation data refer to the latest construction of the singleton. In case it
+ * was deleted and created again, #Creations is greater than \c 1.
+ **************************************************************************************************/
+struct SingletonStatistics
+{
+    /** The singleton's type. */
+    const TypeKey*                          Type;
+
+    /** The singleton. \c nullptr if it was deleted. */
+    void*                                   Instance;
+
+    /**
+     * The creation order: singletons whose construction completed earlier have lower numbers.
+     * (Singletons created by the constructor of another singleton complete first.)
+     */
+    std::size_t                             Sequence;
+
+    /** The number of times the singleton was created. */
+    std::size_t                             Creations;
+
+    /** The thread that constructed the singleton. */
+    std::thread::id                         Creator;
+
+    /** The point in time the construction started. */
+    std::chrono::steady_clock::time_point   Created;
+
+    /**
+     * The wall time of the construction, including the allocation and the construction of
+     * singletons created by the constructor.
+     */
+    std::chrono::nanoseconds                ConstructionTime;
+
+    /**
+     * The number of lookups in the registry. Each code entity (executable or shared library)
+     * looks up a singleton once, unless the singleton is deleted. With
+     * \ref ALIB_FEAT_SINGLETON_THREAD_CACHE_ON, each thread looks it up once per change of the
+     * generation counter.
+     */
+    std::size_t                             Lookups;
+
+    /** The time waited to acquire the registry lock while requesting or storing the singleton. */
+    std::chrono::nanoseconds                LockWaitTime;
+};
+
+/** ************************************************************************************************
+ * Statistics of the lock that guards modifications of the singleton registry, as returned by
+ * \alib{singletons,GetSingletonLockStatistics}.
+ **************************************************************************************************/
+struct SingletonLockStatistics
+{
+    /** The number of times the lock was acquired. */
+    std::size_t                             Acquisitions;
+
+    /** The number of times the lock was acquired only after waiting for another thread. */
+    std::size_t                             Contentions;
+
+    /** The total time waited. */
+    std::chrono::nanoseconds                WaitTime;
+};
+
+//! @cond NO_DOX
+extern ALIB_API void visitSingletonStatistics( void (*visitor)( const SingletonStatistics&, void* ),
+                                               void* data );
+//! @endcond
+
+/** ************************************************************************************************
+ * Invokes \p{visitor} with the statistics of each singleton type that was created since the
+ * start of the process, respectively since the last invocation of
+ * \alib{singletons,DeleteSingletons}, in the reverse order of the first creation of the types.
+ *
+ * No memory is allocated and no lock is held while \p{visitor} is invoked. Hence, the visitor
+ * may request singletons. Types created while visiting might not be visited.
+ *
+ * Available only if code selection symbol \ref ALIB_FEAT_SINGLETON_STATISTICS is true, which
+ * is enabled with compiler symbol \ref ALIB_FEAT_SINGLETON_STATISTICS_ON. Then, the creation,
+ * lookup and removal of singletons record statistics, which adds a few reads of the steady
+ * clock to the creation of a singleton. Accesses to existing singletons are not affected.
+ *
+ * @param visitor A callable that accepts a <c>const SingletonStatistics&</c>.
+ * @tparam TVisitor The type of \p{visitor}.
+ **************************************************************************************************/
+template<typename TVisitor>
+void VisitSingletonStatistics( TVisitor&& visitor )
+{
+    using TPointer= typename std::remove_reference<TVisitor>::type*;
+    TPointer pointer= &visitor;
+    visitSingletonStatistics( []( const SingletonStatistics& statistics, void* data )
+                              {
+                                  (**static_cast<TPointer*>( data ))( statistics );
+                              },
+                              &pointer );
+}
+
+/** ************************************************************************************************
+ * Returns the statistics of the lock that guards modifications of the singleton registry.
+ * Available only if code selection symbol \ref ALIB_FEAT_SINGLETON_STATISTICS is true.
+ * @return The lock statistics.
+ **************************************************************************************************/
+ALIB_API SingletonLockStatistics GetSingletonLockStatistics();
+
+}}} // namespace [aworx::lib::singletons]
+
+#endif // ALIB_FEAT_SINGLETON_STATISTICS || ALIB_DOCUMENTATION_PARSER
+
+#endif // HPP_ALIB_SINGLETONS_STATISTICS
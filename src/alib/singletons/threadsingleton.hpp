@@ -0,0 +1,318 @@
+// #################################################################################################
+//  ALib C++ Library
+//
+//  Module Singletons
+//
+//  Copyright 2013-2019 A-Worx GmbH, Germany
+//  Published under 'Boost Software License' (a free software license, see LICENSE.txt)
+// #################################################################################################
+#ifndef HPP_ALIB_SINGLETONS_THREADSINGLETON
+#define HPP_ALIB_SINGLETONS_THREADSINGLETON 1
+
+#if !defined (HPP_ALIB_SINGLETONS_SINGLETON)
+#   include "alib/singletons/singleton.hpp"
+#endif
+
+#if !defined (_GLIBCXX_MUTEX) && !defined(_MUTEX_)
+#   include <mutex>
+#endif
+
+#if !defined (_GLIBCXX_THREAD) && !defined(_THREAD_)
+#   include <thread>
+#endif
+
+namespace aworx { namespace lib { namespace singletons {
+
+/** ************************************************************************************************
+ * A variant of class \alib{singletons,Singleton}, which provides one instance of
+ * \p{TDerivedClass} per thread. This is useful for objects that are used by many threads, but
+ * which do not need to be shared, like buffers, random number generators or statistics that are
+ * aggregated only occasionally. Threads access their instance without locking.
+ *
+ * The instance of a thread is created with the first invocation of #GetSingleton by that thread
+ * and deleted when the thread exits. The instances of all living threads can be visited with
+ * #ForEach. Destructors of \p{TDerivedClass} may be used to aggregate results of exiting threads.
+ *
+ * With mapped mode, the list of instances is a singleton itself and hence shared among all
+ * code entities (executable and shared libraries) of a process. Each code entity caches the
+ * instance of a thread once it was received.
+ *
+ * The instance received by a thread is validated with the global generation counter of
+ * singletons, as done by the thread-local cache of \alib{singletons,Singleton}. Hence, after
+ * \alib{singletons,DeleteSingletons} deleted the instances of threads that are still alive,
+ * these threads receive new instances with their next invocation of #GetSingleton.
+ *
+ * \attention
+ *   - Method #GetSingleton must not be invoked by destructors of thread-local objects, as these
+ *     might run after the instance of the thread was deleted.
+ *   - References to instances must not be kept across \alib{singletons,DeleteSingletons}.
+ *
+ * @tparam TDerivedClass Template parameter that denotes the name of the class that implements
+ *                       the thread singleton.
+ **************************************************************************************************/
+template <typename TDerivedClass>
+class ThreadSingleton
+{
+    protected:
+        /** An instance of a thread. */
+        struct Node;
+
+        /**
+         * The list of instances. Insertions are lock-free, while removals and iterations
+         * acquire #lock. The list is reference counted by #Instances and by the nodes, because
+         * threads might exit while or after \alib{singletons,DeleteSingletons} deletes
+         * #Instances.
+         */
+        struct List
+        {
+            /** The first node of the list. */
+            std::atomic<Node*>          first;
+
+            /** Acquired for removals and iterations. */
+            std::mutex                  lock;
+
+            /** The number of references. */
+            std::atomic<std::size_t>    references;
+
+            /** Constructor. Creates the reference of #Instances. */
+            List()
+            : first     ( nullptr )
+            , references( 1 )
+            {}
+
+            /** Adds a reference. */
+            void Acquire()
+            {
+                references.fetch_add( 1, std::memory_order_relaxed );
+            }
+
+            /** Removes a reference. Deletes the list with the last one. */
+            void Release()
+            {
+                if( references.fetch_sub( 1, std::memory_order_acq_rel ) == 1 )
+                    delete this;
+            }
+
+            /**
+             * Inserts a node. Lock-free.
+             * @param node The node to insert.
+             */
+            void Insert( Node* node )
+            {
+                node->next= first.load( std::memory_order_relaxed );
+                while( !first.compare_exchange_weak( node->next, node, std::memory_order_release,
+                                                                      std::memory_order_relaxed ) )
+                {}
+            }
+
+            /**
+             * Removes a node. Must be invoked only while #lock is acquired.
+             * @param node The node to remove.
+             */
+            void Remove( Node* node )
+            {
+                // insertions only change the first node
+                Node* expected= node;
+                if( first.compare_exchange_strong( expected, node->next, std::memory_order_relaxed ) )
+                    return;
+
+                Node* previous= first.load( std::memory_order_acquire );
+                while( previous->next != node )
+                    previous= previous->next;
+                previous->next= node->next;
+            }
+        };
+
+        /** Holds the list of instances. */
+        class Instances : public Singleton<Instances>
+        {
+            public:
+                /** The list. */
+                List*               list;
+
+                /** Constructor. */
+                Instances()
+                : list( new List() )
+                {}
+
+                /**
+                 * Destructor. Deletes the instances of threads which are still alive. Their nodes
+                 * are deleted by the threads on exit, which release the list with the last one.
+                 */
+                virtual ~Instances()
+                {
+                    {
+                        std::lock_guard<std::mutex> guard( list->lock );
+                        for( Node* node= list->first.load( std::memory_order_acquire ) ; node ; node= node->next )
+                        {
+                            delete node->instance;
+                            node->orphaned= true;
+                        }
+                        list->first.store( nullptr, std::memory_order_relaxed );
+                    }
+                    list->Release();
+                }
+        };
+
+        /** An instance of a thread. */
+        struct Node
+        {
+            TDerivedClass*      instance;   ///< The instance.
+            std::thread::id     owner;      ///< The thread that created the instance.
+            List*               list;       ///< The list that this node is inserted in.
+            Node*               next;       ///< The next node in the list.
+            bool                orphaned;   ///< Set when #instance was deleted with the list's owner.
+
+            /**
+             * Constructor. Adds a reference to the list.
+             * @param pInstance The instance.
+             * @param pList     The list that this node will be inserted in.
+             */
+            Node( TDerivedClass* pInstance, List* pList )
+            : instance( pInstance )
+            , owner   ( std::this_thread::get_id() )
+            , list    ( pList )
+            , next    ( nullptr )
+            , orphaned( false )
+            {
+                list->Acquire();
+            }
+        };
+
+        /** Deletes the instance of a thread when the thread exits. */
+        struct Cleanup
+        {
+            /** The node of the thread, \c nullptr if the thread did not create an instance. */
+            Node*   node= nullptr;
+
+            /** Destructor. Removes and deletes the instance of the thread. */
+            ~Cleanup()
+            {
+                Release();
+            }
+
+            /**
+             * Removes and deletes the instance of the thread, unless it was deleted with the
+             * list's owner. Deletes #node.
+             */
+            void Release()
+            {
+                if( node == nullptr )
+                    return;
+
+                threadInstance= nullptr;
+                List* list= node->list;
+                {
+                    // orphaned is checked while the lock is acquired, as the list's owner might
+                    // be deleted concurrently
+                    std::lock_guard<std::mutex> guard( list->lock );
+                    if( !node->orphaned )
+                    {
+                        list->Remove( node );
+                        delete node->instance;
+                    }
+                }
+                delete node;
+                node= nullptr;
+                list->Release();
+            }
+        };
+
+        /** The instance of the current thread, as received by this code entity. */
+        static thread_local TDerivedClass*  threadInstance;
+
+        /** The \c singletonGeneration that #threadInstance was received in. */
+        static thread_local std::size_t     threadGeneration;
+
+        /**
+         * Deletes the instance of the current thread on thread exit. Set only in the code entity
+         * that created the instance.
+         */
+        static thread_local Cleanup         cleanup;
+
+    public:
+        /**
+         * Creates (if not done, yet) and returns the instance of the current thread.
+         * @return The instance of the current thread.
+         */
+        inline static TDerivedClass&    GetSingleton()
+        {
+            TDerivedClass* result= threadInstance;
+            if(    result != nullptr
+                && threadGeneration == singletonGeneration.load( std::memory_order_acquire ) )
+                return *result;
+
+            return *createSingleton();
+        }
+
+        /**
+         * Invokes \p{callable} with the instance of each living thread that created one.
+         * While iterating, threads cannot exit and (with mapped mode) other code entities
+         * cannot receive instances. Threads that access their instances concurrently are not
+         * blocked, hence fields visited have to be atomic or otherwise synchronized.
+         *
+         * @param callable A callable that accepts a reference to \p{TDerivedClass}.
+         * @tparam TCallable The type of \p{callable}.
+         */
+        template<typename TCallable>
+        static void                     ForEach( TCallable&& callable )
+        {
+            List* list= Instances::GetSingleton().list;
+            std::lock_guard<std::mutex> guard( list->lock );
+            for( Node* node= list->first.load( std::memory_order_acquire ) ; node ; node= node->next )
+                callable( *node->instance );
+        }
+
+    protected:
+        /**
+         * The slow path of #GetSingleton. Creates the instance of the current thread, or, in case
+         * another code entity did this already or the generation changed for other reasons,
+         * receives it.
+         * @return The instance of the current thread.
+         */
+        static TDerivedClass*           createSingleton()
+        {
+            // read before the lookup: a deletion in between invalidates the instance again
+            std::size_t generation= singletonGeneration.load( std::memory_order_acquire );
+            List*       list      = Instances::GetSingleton().list;
+            {
+                std::lock_guard<std::mutex> guard( list->lock );
+                std::thread::id self= std::this_thread::get_id();
+                for( Node* node= list->first.load( std::memory_order_acquire ) ; node ; node= node->next )
+                    if( node->owner == self )
+                    {
+                        threadGeneration= generation;
+                        return threadInstance= node->instance;
+                    }
+            }
+
+            // a node of this code entity that is not listed was deleted with a previous list
+            cleanup.Release();
+
+            Node* node= new Node( new TDerivedClass(), list );
+            list->Insert( node );
+            cleanup.node    = node;
+            threadGeneration= generation;
+            return threadInstance= node->instance;
+        }
+};// class ThreadSingleton
+
+template <typename TDerivedClass>
+thread_local TDerivedClass*    ThreadSingleton<TDerivedClass>::threadInstance= nullptr;
+
+template <typename TDerivedClass>
+thread_local std::size_t       ThreadSingleton<TDerivedClass>::threadGeneration= 0;
+
+template <typename TDerivedClass>
+thread_local typename ThreadSingleton<TDerivedClass>::Cleanup
+                               ThreadSingleton<TDerivedClass>::cleanup;
+
+}} // namespace aworx[::lib::singletons]
+
+/// Type alias in namespace #aworx.
+template<typename T>
+using ThreadSingleton=    aworx::lib::singletons::ThreadSingleton<T>;
+
+} // namespace aworx
+
+#endif // HPP_ALIB_SINGLETONS_THREADSINGLETON
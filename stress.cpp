@@ -0,0 +1,225 @@
+// #################################################################################################
+//  ALib - A-Worx Utility Library
+//  Singleton Stress Test
+//
+//  Copyright 2019 A-Worx GmbH, Germany
+//  Published under Boost Software License (a free software license, see LICENSE.txt)
+//
+//  8 threads request the same singletons of 16 types concurrently, in several rounds that are
+//  separated by DeleteSingletons(). Returns 1, if a singleton was constructed more than once per
+//  round, if threads received different instances or if an instance was received before its
+//  construction completed. With mapped mode, each round further replaces a singleton while
+//  threads resolve it for the first time in their code entity, and returns 1, if the code entity
+//  caches a singleton other than the last replacement afterwards.
+//  Option --rounds N sets the number of rounds (default: 50).
+//  To detect data races, compile with -fsanitize=thread (CMake option ALIB_SINGLETON_STRESS_TSAN).
+// #################################################################################################
+
+#if !defined (HPP_ALIB_SINGLETONS_SINGLETON)
+#include "alib/singletons/singleton.hpp"
+#endif
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr int   ThreadCount= 8;
+constexpr int   TypeCount  = 16;
+
+/** The number of constructions per type. */
+std::atomic<int>    constructions[TypeCount];
+
+/** Set to start the threads of a round at once. */
+std::atomic<bool>   start( false );
+
+/** A singleton type. The constructor yields, to widen the window of concurrent creation. */
+template<int N>
+struct Stressed : public aworx::Singleton<Stressed<N>>
+{
+    int payload;
+
+    Stressed()
+    {
+        constructions[N].fetch_add( 1, std::memory_order_relaxed );
+        std::this_thread::yield();
+        payload= N;
+    }
+};
+
+/** Requests the singletons of types \p{N} to \c TypeCount - 1 and stores their addresses. */
+template<int N>
+struct Request
+{
+    static bool run( const void** received )
+    {
+        Stressed<N>& singleton= Stressed<N>::GetSingleton();
+        received[N]= &singleton;
+        return singleton.payload == N && Request<N + 1>::run( received );
+    }
+};
+
+template<>
+struct Request<TypeCount>
+{
+    static bool run( const void** )
+    {
+        return true;
+    }
+};
+
+/** A singleton type that is replaced while it is resolved. */
+struct Replaced : public aworx::Singleton<Replaced>
+{
+    int payload= TypeCount;
+
+    /** Resets the pointer that caches the singleton in this code entity. */
+    static void forget()
+    {
+        singleton.store( nullptr, std::memory_order_relaxed );
+    }
+};
+
+/** Runs one round. Returns \c false on failure. */
+bool round( int number )
+{
+    const void*  received[ThreadCount][TypeCount];
+    bool         complete[ThreadCount];
+    int          before  [TypeCount];
+    for( int type= 0 ; type < TypeCount ; ++type )
+        before[type]= constructions[type].load();
+
+    std::vector<std::thread> threads;
+    start.store( false );
+    for( int thread= 0 ; thread < ThreadCount ; ++thread )
+        threads.emplace_back( [thread, &received, &complete]()
+        {
+            while( !start.load( std::memory_order_acquire ) )
+                std::this_thread::yield();
+            complete[thread]= Request<0>::run( received[thread] );
+        } );
+    start.store( true, std::memory_order_release );
+    for( std::thread& thread : threads )
+        thread.join();
+
+    // in unmapped mode, DeleteSingletons does not delete singletons
+    #if ALIB_FEAT_SINGLETON_MAPPED
+        int expected= 1;
+    #else
+        int expected= number == 0 ? 1 : 0;
+    #endif
+
+    bool success= true;
+    for( int type= 0 ; type < TypeCount ; ++type )
+    {
+        int count= constructions[type].load() - before[type];
+        if( count != expected )
+        {
+            std::printf( "round %d: type %d constructed %d times\n", number, type, count );
+            success= false;
+        }
+        for( int thread= 1 ; thread < ThreadCount ; ++thread )
+            if( received[thread][type] != received[0][type] )
+            {
+                std::printf( "round %d: type %d received as different instances\n", number, type );
+                success= false;
+                break;
+            }
+    }
+    for( int thread= 0 ; thread < ThreadCount ; ++thread )
+        if( !complete[thread] )
+        {
+            std::printf( "round %d: thread %d received an incomplete instance\n", number, thread );
+            success= false;
+        }
+
+    aworx::lib::singletons::DeleteSingletons();
+    return success;
+}
+
+#if ALIB_FEAT_SINGLETON_MAPPED
+/**
+ * Replaces singleton \c Replaced, while the other threads resolve it. Before, the pointer that
+ * caches the singleton in this code entity is reset, hence each thread resolves it as if it was
+ * the first request of a code entity. Returns \c false, if the code entity caches a singleton
+ * other than the last replacement afterwards.
+ */
+bool replaceRound( int number )
+{
+    constexpr int Iterations= 16;
+
+    Replaced::GetSingleton();
+    bool success= true;
+    for( int iteration= 0 ; iteration < Iterations ; ++iteration )
+    {
+        Replaced::forget();
+
+        std::atomic<int>         invalid( 0 );
+        Replaced*                last= nullptr;
+        std::vector<std::thread> threads;
+        start.store( false );
+        for( int thread= 1 ; thread < ThreadCount ; ++thread )
+            threads.emplace_back( [&invalid]()
+            {
+                while( !start.load( std::memory_order_acquire ) )
+                    std::this_thread::yield();
+                aworx::SingletonReadGuard guard;
+                if( Replaced::GetSingleton().payload != TypeCount )
+                    invalid.fetch_add( 1, std::memory_order_relaxed );
+            } );
+        threads.emplace_back( [&last]()
+        {
+            while( !start.load( std::memory_order_acquire ) )
+                std::this_thread::yield();
+            last= new Replaced();
+            Replaced::Replace( std::unique_ptr<Replaced>( last ) );
+        } );
+        start.store( true, std::memory_order_release );
+        for( std::thread& thread : threads )
+            thread.join();
+
+        if( invalid.load() != 0 )
+        {
+            std::printf( "round %d: %d threads received an invalid replacement\n", number,
+                         invalid.load() );
+            success= false;
+        }
+        if( &Replaced::GetSingleton() != last )
+        {
+            std::printf( "round %d: a replaced singleton is cached in iteration %d\n", number,
+                         iteration );
+            success= false;
+            break;
+        }
+    }
+    return success;
+}
+#endif
+
+} // anonymous namespace
+
+int main( int argc, char** argv )
+{
+    int rounds= 50;
+    for( int arg= 1 ; arg < argc ; ++arg )
+        if( std::strcmp( argv[arg], "--rounds" ) == 0 && arg + 1 < argc )
+            rounds= std::atoi( argv[++arg] );
+
+    bool success= true;
+    for( int number= 0 ; number < rounds ; ++number )
+    {
+        #if ALIB_FEAT_SINGLETON_MAPPED
+            success= replaceRound( number ) && success;
+        #endif
+        success= round( number ) && success;
+    }
+
+    std::printf( "%d threads x %d types x %d rounds: %s\n", ThreadCount, TypeCount, rounds,
+                 success ? "passed" : "FAILED" );
+    return success ? 0 : 1;
+}